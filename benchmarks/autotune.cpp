@@ -0,0 +1,55 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstddef>
+#include <cstdlib>
+
+#include "autotune.hpp"
+
+/* Measures the crossover thresholds of the library on this host and writes
+ * the tuning profile (to stdout or to --output). Pointing the environment
+ * variable FGS_TUNING_PROFILE to that file makes every program use it.
+ *
+ * Usage: autotune [--max-size N] [--min-time S] [--inexact-fft] [--output FILE]
+ *
+ * --inexact-fft also tunes the FFT products of the floating-point types,
+ * which by default never use it (they are faster, but much less accurate)
+ */
+int main(int argc, char* argv[]){
+    fgs::tuning::AutotuneOptions opt;
+    std::string output;
+
+    for (int i=1; i<argc; ++i){
+        const std::string arg = argv[i];
+        const bool has_value = i+1 < argc;
+
+        if (arg == "--max-size" && has_value)
+            opt.max_size = std::stoul(argv[++i]);
+        else if (arg == "--min-time" && has_value)
+            opt.min_time = std::stod(argv[++i]);
+        else if (arg == "--inexact-fft")
+            opt.inexact_fft = true;
+        else if (arg == "--output" && has_value)
+            output = argv[++i];
+        else{
+            std::cerr << "Usage: " << argv[0] << " [--max-size N] [--min-time S] [--inexact-fft] [--output FILE]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Start from the defaults, not from a profile loaded from the environment
+    fgs::tuning::set_profile({});
+    const auto profile = fgs::tuning::autotune_all(opt);
+
+    if (output.empty()){
+        std::cout << "# Written by fgs::tuning::autotune_all\n";
+        fgs::tuning::write_profile(std::cout, profile);
+    }
+    else{
+        std::ofstream file(output);
+        file << "# Written by fgs::tuning::autotune_all\n";
+        fgs::tuning::write_profile(file, profile);
+    }
+
+    return 0;
+}
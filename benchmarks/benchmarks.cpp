@@ -0,0 +1,298 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <complex>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+#include "polynomial.hpp"
+#include "polynomial_io.hpp"
+#include "compensated.hpp"
+
+/* Benchmark suite for the hot paths of the library
+ *
+ * Every operation is timed for degrees 2, 4, 8,... and --max-degree
+ * (10^6 by default) with the six coefficient types. Quadratic or worse
+ * operations stop at their own cap (products, division and pow at
+ * QUADRATIC_CAP), so the whole sweep stays in minutes.
+ * Each measurement repeats the operation until --min-time seconds have
+ * passed and reports the mean time per call.
+ *
+ * The results are written as JSON (to stdout or to --output), so they can
+ * be compared between releases.
+ *
+ * Usage: benchmarks [--max-degree N] [--min-time S] [--filter OP] [--type T] [--output FILE]
+ */
+
+namespace{
+
+struct Options{
+    std::size_t max_degree = 1000000;
+    double min_time = 0.1;
+    std::string filter;     // Only operations whose name contains it
+    std::string type;       // Only this coefficient type
+    std::string output;     // stdout if empty
+};
+
+struct Result{
+    std::string operation;
+    std::string type;
+    std::size_t degree;
+    std::size_t iterations;
+    double seconds;         // Mean time per call
+};
+
+// Keeps the compiler from dropping the benchmarked calls
+volatile std::size_t sink = 0;
+
+std::mt19937 gen(12345);
+
+template <typename T>
+T random_coefficient(){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    std::uniform_real_distribution<Real> unif(Real(-1), Real(1));
+
+    if constexpr (fgs::detail::is_complex_v<T>)
+        return T(unif(gen), unif(gen));
+    else
+        return unif(gen);
+}
+
+template <typename T>
+fgs::Polynomial<T> random_polynomial(std::size_t n){
+    std::vector<T> v(n+1);
+    std::generate(v.begin(), v.end(), random_coefficient<T>);
+    if (v.back() == T(0))
+        v.back() = T(1);
+
+    return fgs::Polynomial<T>(v);
+}
+
+template <typename T>
+std::vector<T> random_vector(std::size_t n){
+    std::vector<T> v(n);
+    std::generate(v.begin(), v.end(), random_coefficient<T>);
+    return v;
+}
+
+// Mean time of fn, repeated until min_time seconds have passed (at least once, after a warm-up call)
+Result measure(const std::string& operation, const std::string& type, std::size_t degree,
+               const std::function<void()>& fn, double min_time){
+    using clock = std::chrono::steady_clock;
+
+    fn();
+
+    std::size_t iterations = 0;
+    const auto start = clock::now();
+    std::chrono::duration<double> elapsed{};
+    do{
+        fn();
+        ++iterations;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < min_time);
+
+    return {operation, type, degree, iterations, elapsed.count()/static_cast<double>(iterations)};
+}
+
+/* Cap of the products and everything built on them. Floating-point products
+ * are schoolbook unless a tuning profile enables the FFT (and division is
+ * always the long one), so they are quadratic: at degree 16384 a double
+ * product takes about 0.2 seconds, and a complex<long double> one about 4
+ */
+constexpr std::size_t QUADRATIC_CAP = 16384;
+
+// An operation: its name, the highest degree it is run with, and the setup that returns the call to time
+struct Operation{
+    std::string name;
+    std::size_t cap;
+    std::function<std::function<void()>(std::size_t)> setup;
+};
+
+template <typename T>
+std::vector<Operation> operations(){
+    std::vector<Operation> ret = {
+        {"multiplication", QUADRATIC_CAP, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n), q = random_polynomial<T>(n)](){ sink = sink + (p*q).degree(); };
+        }},
+        {"division", QUADRATIC_CAP, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(2*n), q = random_polynomial<T>(n)](){ sink = sink + (p/q).degree(); };
+        }},
+        {"modulus", QUADRATIC_CAP, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(2*n), q = random_polynomial<T>(n)](){ sink = sink + (p%q).degree(); };
+        }},
+        {"gcd", 2048, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n), q = random_polynomial<T>(n)](){ sink = sink + fgs::gcd(p, q).degree(); };
+        }},
+        {"pow", QUADRATIC_CAP, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(std::max<std::size_t>(n/8, 1))](){ sink = sink + fgs::pow(p, 8).degree(); };
+        }},
+        {"evaluate_at", 1000000, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n), x = random_coefficient<T>()](){
+                sink = sink + static_cast<std::size_t>(std::abs(p(x)) > 0);
+            };
+        }},
+        {"roots_of", 256, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n)](){ sink = sink + fgs::roots_of(p).size(); };
+        }},
+        {"lagrange_polynomial", 128, [](std::size_t n) -> std::function<void()>{
+            return [x = random_vector<T>(n+1), y = random_vector<T>(n+1)](){
+                sink = sink + fgs::lagrange_polynomial(x, y).degree();
+            };
+        }},
+        {"taylor_polynomial", 4096, [](std::size_t n) -> std::function<void()>{
+            return [d = random_vector<T>(n+1), a = random_coefficient<T>()](){
+                sink = sink + fgs::taylor_polynomial(a, d).degree();
+            };
+        }},
+        {"cyclotomic_polynomial", 1024, [](std::size_t n) -> std::function<void()>{
+            return [n](){ sink = sink + fgs::cyclotomic_polynomial<T>(static_cast<unsigned>(n)).degree(); };
+        }},
+        {"output", 100000, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n)](){
+                std::ostringstream os;
+                os << p;
+                sink = sink + os.str().size();
+            };
+        }},
+        {"input", 100000, [](std::size_t n) -> std::function<void()>{
+            std::ostringstream os;
+            os << random_polynomial<T>(n);
+
+            return [s = os.str()](){
+                fgs::Polynomial<T> p;
+                fgs::from_chars(s.data(), s.data()+s.size(), p);
+                sink = sink + p.degree();
+            };
+        }},
+        {"make_polynomial_by_roots", QUADRATIC_CAP, [](std::size_t n) -> std::function<void()>{
+            return [r = random_vector<T>(n)](){ sink = sink + fgs::make_polynomial_by_roots(r).degree(); };
+        }},
+        {"evaluate_at_polynomial", 4096, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n), q = random_polynomial<T>(2)](){
+                sink = sink + p(q).degree();
+            };
+        }}
+    };
+
+    // Only real coefficients have a compensated evaluation
+    if constexpr (std::is_floating_point_v<T>)
+        ret.push_back({"compensated_evaluate", 1000000, [](std::size_t n) -> std::function<void()>{
+            return [p = random_polynomial<T>(n), x = random_coefficient<T>()](){
+                sink = sink + static_cast<std::size_t>(std::abs(fgs::compensated_evaluate(p, x)) > 0);
+            };
+        }});
+
+    return ret;
+}
+
+// 2, 4, 8,... below limit, and limit itself (so a sweep to 10^6 ends at 10^6)
+std::vector<std::size_t> degrees(std::size_t limit){
+    std::vector<std::size_t> ret;
+    for (std::size_t n=2; n<limit; n*=2)
+        ret.push_back(n);
+    if (limit >= 2)
+        ret.push_back(limit);
+
+    return ret;
+}
+
+template <typename T>
+void run_type(const std::string& type, const Options& opt, std::vector<Result>& results){
+    if (!opt.type.empty() && opt.type != type)
+        return;
+
+    for (const auto &op : operations<T>()){
+        if (op.name.find(opt.filter) == std::string::npos)
+            continue;
+
+        for (const auto n : degrees(std::min(op.cap, opt.max_degree))){
+            results.push_back(measure(op.name, type, n, op.setup(n), opt.min_time));
+            std::clog << op.name << " <" << type << "> " << n << ": " << results.back().seconds << " s\n";
+        }
+    }
+}
+
+void write_json(std::ostream& os, const Options& opt, const std::vector<Result>& results){
+    os.precision(9);
+    os << "{\n"
+       << "  \"context\": {\n"
+       << "    \"library\": \"polynomials\",\n"
+#ifdef __VERSION__
+       << "    \"compiler\": \"" << __VERSION__ << "\",\n"
+#endif
+       << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+       << "    \"max_degree\": " << opt.max_degree << ",\n"
+       << "    \"min_time\": " << opt.min_time << "\n"
+       << "  },\n"
+       << "  \"benchmarks\": [";
+
+    for (std::size_t i=0; i<results.size(); ++i){
+        const auto &r = results[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"operation\": \"" << r.operation << "\", \"type\": \"" << r.type
+           << "\", \"degree\": " << r.degree << ", \"iterations\": " << r.iterations
+           << ", \"seconds\": " << r.seconds
+           << ", \"coefficients_per_second\": " << static_cast<double>(r.degree+1)/r.seconds << "}";
+    }
+
+    os << "\n  ]\n}\n";
+}
+
+Options parse_options(int argc, char* argv[]){
+    Options opt;
+
+    for (int i=1; i<argc; ++i){
+        const std::string arg = argv[i];
+        const bool has_value = i+1 < argc;
+
+        if (arg == "--max-degree" && has_value)
+            opt.max_degree = std::stoul(argv[++i]);
+        else if (arg == "--min-time" && has_value)
+            opt.min_time = std::stod(argv[++i]);
+        else if (arg == "--filter" && has_value)
+            opt.filter = argv[++i];
+        else if (arg == "--type" && has_value)
+            opt.type = argv[++i];
+        else if (arg == "--output" && has_value)
+            opt.output = argv[++i];
+        else{
+            std::cerr << "Usage: " << argv[0]
+                      << " [--max-degree N] [--min-time S] [--filter OP] [--type T] [--output FILE]\n"
+                      << "Types: float, double, long_double, complex_float, complex_double, complex_long_double\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return opt;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]){
+    const Options opt = parse_options(argc, argv);
+    std::vector<Result> results;
+
+    run_type<float>("float", opt, results);
+    run_type<double>("double", opt, results);
+    run_type<long double>("long_double", opt, results);
+    run_type<std::complex<float>>("complex_float", opt, results);
+    run_type<std::complex<double>>("complex_double", opt, results);
+    run_type<std::complex<long double>>("complex_long_double", opt, results);
+
+    if (opt.output.empty())
+        write_json(std::cout, opt, results);
+    else{
+        std::ofstream file(opt.output);
+        write_json(file, opt, results);
+    }
+
+    return 0;
+}
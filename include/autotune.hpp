@@ -0,0 +1,193 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "modint.hpp"
+#include "tuning.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::generate
+#include <chrono>       // std::chrono::steady_clock
+#include <complex>      // std::complex
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int64_t
+#include <functional>   // std::function
+#include <random>       // std::mt19937, std::uniform_real_distribution, std::uniform_int_distribution
+#include <type_traits>  // std::is_floating_point_v, std::is_integral_v
+
+/* Autotuner of the crossover thresholds (see tuning.hpp)
+ *
+ * For each threshold, the operation it dispatches is timed at sizes 8, 16,
+ * 32,... up to max_size, once forcing the quadratic kernel and once forcing
+ * the fast one. The threshold becomes the smallest size from which the fast
+ * kernel wins at every larger size measured (or tuning::NEVER if it doesn't
+ * win at max_size). The thresholds are tuned in dependency order (products
+ * first, since the other fast kernels are built on them), and the result is
+ * installed in the running profile.
+ *
+ * It takes a few seconds per type, so it's meant to run once per host: at
+ * startup, or through the autotune program of the benchmarks, whose output
+ * is the profile FGS_TUNING_PROFILE should point to
+ */
+namespace fgs::tuning{
+    struct AutotuneOptions{
+        std::size_t max_size = 1024;    // Largest size measured
+        double min_time = 0.005;        // Seconds each measurement is repeated for
+        bool inexact_fft = false;       // Tune the FFT of floating-point types too (see below)
+    };
+
+    namespace autotune_aux{
+        template <typename T>
+        T random_coefficient (std::mt19937& gen){
+            using Real = fgs::detail::reduce_complex_t<T>;
+
+            if constexpr (std::is_floating_point_v<Real>){
+                std::uniform_real_distribution<Real> unif(Real(-1), Real(1));
+                if constexpr (fgs::detail::is_complex_v<T>)
+                    return T(unif(gen), unif(gen));
+                else
+                    return unif(gen);
+            }
+            else{
+                std::uniform_int_distribution<int> unif(-1000, 1000);
+                return T(unif(gen));
+            }
+        }
+
+        // Random polynomial with n coefficients and a nonzero leading one
+        template <typename T>
+        Polynomial<T> random_polynomial (std::size_t n, std::mt19937& gen){
+            std::vector<T> v(n);
+            std::generate(v.begin(), v.end(), [&gen](){ return random_coefficient<T>(gen); });
+            if (v.back() == T(0))
+                v.back() = T(1);
+
+            return Polynomial<T>(v);
+        }
+
+        // Mean time of fn, repeated until min_time seconds have passed (after a warm-up call)
+        inline double measure (const std::function<void()>& fn, double min_time){
+            using clock = std::chrono::steady_clock;
+            fn();
+
+            std::size_t iterations = 0;
+            const auto start = clock::now();
+            std::chrono::duration<double> elapsed{};
+            do{
+                fn();
+                ++iterations;
+                elapsed = clock::now() - start;
+            } while (elapsed.count() < min_time);
+
+            return elapsed.count()/static_cast<double>(iterations);
+        }
+
+        /* Tunes threshold t of T. setup(n) returns the operation of size n
+         * to time; the other thresholds keep the values in current
+         */
+        template <typename T>
+        std::size_t crossover (Threshold t, Thresholds& current, const AutotuneOptions& opt,
+                               const std::function<std::function<void()>(std::size_t)>& setup){
+            const auto index = static_cast<std::size_t>(t);
+            std::size_t ret = NEVER;
+
+            // From the largest size down, while the fast kernel keeps winning
+            std::vector<std::size_t> sizes;
+            for (std::size_t n=8; n<=opt.max_size; n*=2)
+                sizes.push_back(n);
+
+            for (auto it = sizes.rbegin(); it != sizes.rend(); ++it){
+                const auto fn = setup(*it);
+
+                current[index] = NEVER;
+                set_thresholds<T>(current);
+                const double slow = measure(fn, opt.min_time);
+
+                current[index] = 0;
+                set_thresholds<T>(current);
+                const double fast = measure(fn, opt.min_time);
+
+                if (fast >= slow)
+                    break;
+                ret = *it;
+            }
+
+            current[index] = ret;
+            set_thresholds<T>(current);
+            return ret;
+        }
+    }
+
+    /* Measures the thresholds of Polynomial<CType> on this host, installs
+     * them (see set_thresholds) and returns them. Thresholds whose fast
+     * kernel is never used with CType keep their current value.
+     *
+     * The timings say nothing about accuracy, and the FFT is faster but much
+     * less accurate than the schoolbook product of floating-point
+     * coefficients (see tuning::INEXACT_DEFAULTS), so their FFT threshold is
+     * only tuned if opt.inexact_fft is set. Newton's division is never used
+     * with them
+     */
+    template <typename CType>
+    Thresholds autotune (const AutotuneOptions& opt = {}){
+        using namespace autotune_aux;
+        std::mt19937 gen(12345);
+        Thresholds current = thresholds<CType>();
+
+        if (!convolution_aux::is_fft_friendly_v<CType> || opt.inexact_fft)
+            crossover<CType>(Threshold::fft, current, opt, [&gen](std::size_t n) -> std::function<void()>{
+                return [p = random_polynomial<CType>(n, gen), q = random_polynomial<CType>(n, gen)](){ (void)(p*q); };
+            });
+
+        if constexpr (division_aux::use_newton_v<CType>)
+            crossover<CType>(Threshold::newton, current, opt, [&gen](std::size_t n) -> std::function<void()>{
+                return [p = random_polynomial<CType>(2*n-1, gen), q = random_polynomial<CType>(n, gen)](){ (void)(p/q); };
+            });
+
+        if constexpr (gcd_aux::use_half_gcd_v<CType>)
+            crossover<CType>(Threshold::half_gcd, current, opt, [&gen](std::size_t n) -> std::function<void()>{
+                return [p = random_polynomial<CType>(n+1, gen), q = random_polynomial<CType>(n+1, gen)](){ (void)gcd(p, q); };
+            });
+
+        if constexpr (shift_aux::use_convolution_v<CType>)
+            crossover<CType>(Threshold::taylor_shift, current, opt, [&gen](std::size_t n) -> std::function<void()>{
+                return [c = random_polynomial<CType>(n, gen), a = random_coefficient<CType>(gen)](){
+                    auto shifted(c);
+                    shifted.taylor_shift(a);
+                };
+            });
+
+        // The products of the remainder tree of integer points overflow long before it could pay off
+        if constexpr (!std::is_integral_v<CType>)
+            crossover<CType>(Threshold::evaluation, current, opt, [&gen](std::size_t n) -> std::function<void()>{
+                std::vector<CType> points(n);
+                std::generate(points.begin(), points.end(), [&gen](){ return random_coefficient<CType>(gen); });
+
+                return [tree = ProductTree<CType>(points.begin(), points.end()), p = random_polynomial<CType>(n, gen)](){
+                    (void)tree.evaluate(p);
+                };
+            });
+
+        return current;
+    }
+
+    /* Tunes the six floating-point coefficient types of the polynomial_*
+     * aliases, the NTT-friendly ModInt primes and 64-bit integers (the
+     * types whose dispatchers have the most kernels to choose from: NTT,
+     * Newton's division, half-gcd and Taylor shift, or the multi-modular
+     * product) and returns the resulting profile (the one installed)
+     */
+    inline Profile autotune_all (const AutotuneOptions& opt = {}){
+        autotune<float>(opt);
+        autotune<double>(opt);
+        autotune<long double>(opt);
+        autotune<std::complex<float>>(opt);
+        autotune<std::complex<double>>(opt);
+        autotune<std::complex<long double>>(opt);
+        autotune<modint_998244353>(opt);
+        autotune<modint_167772161>(opt);
+        autotune<modint_469762049>(opt);
+        autotune<std::int64_t>(opt);
+
+        return profile();
+    }
+}  // namespace fgs::tuning
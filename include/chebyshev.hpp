@@ -0,0 +1,626 @@
+#pragma once
+
+#include "detail.hpp"
+#include "convolution.hpp"
+#include "polynomial.hpp"
+
+#include <vector>           // std::vector
+#include <algorithm>        // std::max, std::min
+#include <cmath>            // std::sin, std::acos, std::abs, std::sqrt
+#include <complex>          // std::complex
+#include <cstddef>          // std::size_t
+#include <future>           // std::async, std::future
+#include <limits>           // std::numeric_limits
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>        // std::invalid_argument
+#include <thread>           // std::thread::hardware_concurrency
+#include <type_traits>      // std::is_floating_point_v, std::enable_if_t, std::is_arithmetic_v, std::invoke_result_t
+#include <utility>          // std::move
+
+namespace fgs{
+
+namespace chebyshev_aux{
+    template <typename T>
+    using fft_complex_t = std::complex<convolution_aux::fft_real_t<T>>;
+
+    template <typename T>
+    fft_complex_t<T> to_fft (const T& x){
+        using R = convolution_aux::fft_real_t<T>;
+        if constexpr (detail::is_complex_v<T>)
+            return fft_complex_t<T>(static_cast<R>(x.real()), static_cast<R>(x.imag()));
+        else
+            return fft_complex_t<T>(static_cast<R>(x));
+    }
+
+    template <typename T>
+    T from_fft (const fft_complex_t<T>& x){
+        using Real = detail::reduce_complex_t<T>;
+        if constexpr (detail::is_complex_v<T>)
+            return T(static_cast<Real>(x.real()), static_cast<Real>(x.imag()));
+        else
+            return static_cast<T>(x.real());
+    }
+
+    /* Cosine sums S_k = sum_j x_j*cos(pi*j*k/N), for j, k = 0..N, being
+     * N = x.size()-1 a power of two (or zero). It's a DCT-I (without the
+     * halved ends), computed with an FFT of the even extension of x
+     */
+    template <typename T>
+    std::vector<T> cosine_sums (const std::vector<T>& x){
+        const std::size_t n = x.size()-1;
+        if (n == 0)
+            return x;
+
+        std::vector<fft_complex_t<T>> y(2*n);
+        for (std::size_t j=0; j<=n; ++j)
+            y[j] = to_fft(x[j]);
+        for (std::size_t j=1; j<n; ++j)
+            y[2*n-j] = y[j];
+
+        convolution_aux::fft(y, false);
+
+        std::vector<T> ret(n+1);
+        const auto first = to_fft(x[0]), last = to_fft(x[n]);
+        for (std::size_t k=0; k<=n; ++k)
+            ret[k] = from_fft<T>((y[k] + first + ((k % 2) ? -last : last))/typename fft_complex_t<T>::value_type(2));
+
+        return ret;
+    }
+
+    // Smallest power of two not lower than n
+    inline std::size_t ceil_pow2 (std::size_t n){
+        std::size_t ret = 1;
+        while (ret < n)
+            ret <<= 1;
+        return ret;
+    }
+
+    /* Values of the Chebyshev series c at the n+1 Chebyshev-Lobatto points
+     * cos(pi*j/n), j = 0..n (n a power of two not lower than c.size()-1)
+     */
+    template <typename T>
+    std::vector<T> values (const std::vector<T>& c, std::size_t n){
+        std::vector<T> x(n+1, T(0));
+        std::copy(c.begin(), c.end(), x.begin());
+        return cosine_sums(x);
+    }
+
+    /* Coefficients of the Chebyshev series of degree n that takes the
+     * values v at the Chebyshev-Lobatto points (inverse of values)
+     */
+    template <typename T>
+    std::vector<T> coefficients (std::vector<T> v){
+        using Real = detail::reduce_complex_t<T>;
+        const std::size_t n = v.size()-1;
+        if (n == 0)
+            return v;
+
+        v.front() /= Real(2);
+        v.back() /= Real(2);
+
+        auto c = cosine_sums(v);
+        for (auto &elem : c)
+            elem *= Real(2)/static_cast<Real>(n);
+        c.front() /= Real(2);
+        c.back() /= Real(2);
+
+        return c;
+    }
+
+    // Product of Chebyshev series, from T_i*T_j = (T_{i+j} + T_{|i-j|})/2
+    template <typename T>
+    std::vector<T> multiply_direct (const std::vector<T>& a, const std::vector<T>& b){
+        using Real = detail::reduce_complex_t<T>;
+        std::vector<T> ret(a.size()+b.size()-1, T(0));
+
+        for (std::size_t i=0; i<a.size(); ++i)
+            for (std::size_t j=0; j<b.size(); ++j){
+                const T half = a[i]*b[j]/Real(2);
+                ret[i+j] += half;
+                ret[i > j ? i-j : j-i] += half;
+            }
+
+        return ret;
+    }
+
+    /* Smallest operand size from which products go through multiply_transform.
+     * It's its own crossover, not the FFT threshold of Polynomial (which is
+     * never for floating-point types, since the monomial FFT product loses
+     * accuracy). Measured with double and complex types, where the transform
+     * wins from 512 coefficients on
+     */
+    inline static constexpr std::size_t TRANSFORM_THRESHOLD = 512;
+
+    /* Product of Chebyshev series through the values at enough
+     * Chebyshev-Lobatto points: two transforms, a pointwise product and an
+     * inverse transform
+     */
+    template <typename T>
+    std::vector<T> multiply_transform (const std::vector<T>& a, const std::vector<T>& b){
+        const std::size_t m = a.size()+b.size()-1;
+        const std::size_t n = ceil_pow2(m-1);
+
+        auto va = values(a, n);
+        const auto vb = values(b, n);
+        for (std::size_t j=0; j<=n; ++j)
+            va[j] *= vb[j];
+
+        auto ret = coefficients(std::move(va));
+        ret.resize(m);
+        return ret;
+    }
+}
+
+/* Class ChebyshevPolynomial. A polynomial written in the Chebyshev basis
+ *
+ *   p(x) = c_0*T_0(t) + c_1*T_1(t) + ... + c_n*T_n(t)
+ *
+ * where t = (2x - (a+b))/(b-a) maps the domain [a, b] ([-1, 1] by default)
+ * onto [-1, 1]. In that basis, high-degree polynomials are well conditioned
+ * on their domain, so they keep in double the accuracy the monomial basis
+ * needs long double for.
+ *
+ * Evaluation uses Clenshaw's recurrence (with a variant that runs over
+ * many points at once), differentiation and integration are O(n) in the
+ * basis, and products with both operands of 512 coefficients or more go
+ * through discrete cosine transforms. The coefficients must be
+ * floating-point (real or complex)
+ */
+template <typename CType>
+class ChebyshevPolynomial{
+    static_assert(std::is_floating_point_v<detail::reduce_complex_t<CType>>,
+                  "ChebyshevPolynomial needs floating-point coefficients");
+
+public:
+    using container_type    = std::vector<CType>;
+    using value_type        = CType;
+    using real_type         = detail::reduce_complex_t<CType>;
+    using size_type         = typename container_type::size_type;
+    using const_iterator    = typename container_type::const_iterator;
+    using polynomial_type   = Polynomial<CType>;
+
+    explicit ChebyshevPolynomial (real_type a = real_type(-1), real_type b = real_type(1))
+        : coeffs(1, value_type(0)), lower(a), upper(b) { check_domain(); }
+
+    ChebyshevPolynomial (std::initializer_list<value_type> l, real_type a = real_type(-1), real_type b = real_type(1))
+        : ChebyshevPolynomial(l.begin(), l.end(), a, b) {}
+
+    // Chebyshev coefficients, lowest degree first
+    template <typename InputIt, typename = std::enable_if_t<!std::is_arithmetic_v<InputIt>>>
+    ChebyshevPolynomial (InputIt first, InputIt last, real_type a = real_type(-1), real_type b = real_type(1))
+        : coeffs(first, last), lower(a), upper(b)
+    {
+        check_domain();
+        if (coeffs.empty())
+            coeffs.push_back(value_type(0));
+        adjust_degree();
+    }
+
+    /* Same polynomial as pol, written in the Chebyshev basis of [a, b]:
+     * pol(x) = q(t) with x = ((b-a)*t + (a+b))/2 (a Taylor shift and a
+     * scaling), and q goes to the Chebyshev basis by Horner's scheme
+     * with t*T_k = (T_{k+1} + T_{k-1})/2
+     */
+    template <typename CType2>
+    explicit ChebyshevPolynomial (const Polynomial<CType2>& pol, real_type a = real_type(-1), real_type b = real_type(1))
+        : lower(a), upper(b), var(pol.get_variable())
+    {
+        check_domain();
+
+        const real_type half_width = (upper-lower)/real_type(2), center = (upper+lower)/real_type(2);
+        Polynomial<CType> q(pol);
+        q.taylor_shift(value_type(center)).scale(value_type(half_width));
+
+        coeffs.assign(1, q[q.degree()]);
+        for (size_type k=q.degree(); k>0; --k){
+            multiply_by_t();
+            coeffs[0] += q[k-1];
+        }
+        adjust_degree();
+    }
+
+    /* The polynomial in the monomial basis: Clenshaw's recurrence on
+     * polynomials gives q(t), and t = (2x - (a+b))/(b-a) is substituted by
+     * a scaling and a Taylor shift
+     */
+    explicit operator polynomial_type () const{
+        polynomial_type b1, b2;
+        const polynomial_type t{value_type(0), value_type(1)};
+
+        for (size_type k=coeffs.size()-1; k>0; --k){
+            auto b0 = polynomial_type(value_type(2))*t*b1 - b2 + polynomial_type(coeffs[k]);
+            b2 = std::move(b1);
+            b1 = std::move(b0);
+        }
+        auto q = t*b1 - b2 + polynomial_type(coeffs[0]);
+
+        const real_type half_width = (upper-lower)/real_type(2), center = (upper+lower)/real_type(2);
+        q.scale(value_type(real_type(1)/half_width)).taylor_shift(value_type(-center));
+        q.set_variable(var);
+        return q;
+    }
+
+    polynomial_type to_polynomial () const{
+        return this->operator polynomial_type();
+    }
+
+    const value_type& operator[] (size_type i) const { return coeffs[i]; }
+    const_iterator begin () const noexcept{ return coeffs.begin(); }
+    const_iterator end () const noexcept{ return coeffs.end(); }
+
+    void set_coefficient (size_type i, const value_type& elem){
+        if (i >= coeffs.size())
+            coeffs.resize(i+1, value_type(0));
+
+        coeffs[i] = elem;
+        adjust_degree();
+    }
+
+    size_type degree () const noexcept{ return coeffs.size()-1; }
+
+    // Ends of the domain [a, b]
+    real_type lower_bound () const noexcept{ return lower; }
+    real_type upper_bound () const noexcept{ return upper; }
+
+    char get_variable () const noexcept{ return var; }
+    void set_variable (char c) noexcept{ var = c; }
+
+    // Clenshaw's evaluation at x (which should lie in the domain)
+    template <typename RType>
+    auto evaluate_at (const RType& x) const{
+        using CommonType = std::common_type_t<value_type, RType>;
+        const CommonType t = to_unit(CommonType(x)), two_t = CommonType(2)*t;
+        CommonType b1(0), b2(0);
+
+        for (size_type k=coeffs.size()-1; k>0; --k){
+            const CommonType b0 = CommonType(coeffs[k]) + two_t*b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+
+        return CommonType(coeffs[0]) + t*b1 - b2;
+    }
+
+    /* Clenshaw's evaluation at many points at once. The inner loop runs
+     * over the points, so it vectorizes
+     */
+    template <typename RType>
+    auto evaluate_at (const std::vector<RType>& x) const{
+        using CommonType = std::common_type_t<value_type, RType>;
+        const size_type m = x.size();
+        std::vector<CommonType> t(m), b1(m, CommonType(0)), b2(m, CommonType(0));
+
+        for (size_type j=0; j<m; ++j)
+            t[j] = to_unit(CommonType(x[j]));
+
+        for (size_type k=coeffs.size()-1; k>0; --k){
+            const CommonType c(coeffs[k]);
+            for (size_type j=0; j<m; ++j){
+                const CommonType b0 = c + CommonType(2)*t[j]*b1[j] - b2[j];
+                b2[j] = b1[j];
+                b1[j] = b0;
+            }
+        }
+
+        const CommonType c(coeffs[0]);
+        for (size_type j=0; j<m; ++j)
+            b1[j] = c + t[j]*b1[j] - b2[j];
+
+        return b1;
+    }
+
+    template <typename RType>
+    auto operator() (const RType& x) const{
+        return evaluate_at(x);
+    }
+
+    ChebyshevPolynomial operator+ () const { return *this; }
+    ChebyshevPolynomial operator- () const{
+        ChebyshevPolynomial ret(*this);
+        for (auto &elem : ret.coeffs)
+            elem = -elem;
+        return ret;
+    }
+
+    // Operands of the arithmetic operations must share the domain (std::invalid_argument otherwise)
+    ChebyshevPolynomial& operator+= (const ChebyshevPolynomial& pol){
+        check_same_domain(pol);
+        coeffs.resize(std::max(coeffs.size(), pol.coeffs.size()), value_type(0));
+
+        for (size_type i=0; i<pol.coeffs.size(); ++i)
+            coeffs[i] += pol.coeffs[i];
+
+        adjust_degree();
+        return *this;
+    }
+
+    ChebyshevPolynomial& operator-= (const ChebyshevPolynomial& pol){
+        check_same_domain(pol);
+        coeffs.resize(std::max(coeffs.size(), pol.coeffs.size()), value_type(0));
+
+        for (size_type i=0; i<pol.coeffs.size(); ++i)
+            coeffs[i] -= pol.coeffs[i];
+
+        adjust_degree();
+        return *this;
+    }
+
+    /* Products of large operands go through the values at Chebyshev
+     * points (DCT), from chebyshev_aux::TRANSFORM_THRESHOLD; small ones use
+     * T_i*T_j = (T_{i+j} + T_{|i-j|})/2
+     */
+    ChebyshevPolynomial& operator*= (const ChebyshevPolynomial& pol){
+        check_same_domain(pol);
+
+        if (std::min(coeffs.size(), pol.coeffs.size()) >= chebyshev_aux::TRANSFORM_THRESHOLD)
+            coeffs = chebyshev_aux::multiply_transform(coeffs, pol.coeffs);
+        else
+            coeffs = chebyshev_aux::multiply_direct(coeffs, pol.coeffs);
+
+        adjust_degree();
+        return *this;
+    }
+
+    ChebyshevPolynomial& operator*= (const value_type& s){
+        for (auto &elem : coeffs)
+            elem *= s;
+
+        adjust_degree();
+        return *this;
+    }
+
+    /* Derivative (with respect to x), with the recurrence
+     * c'_{k-1} = c'_{k+1} + 2k*c_k
+     */
+    ChebyshevPolynomial& differentiate (){
+        const size_type n = coeffs.size()-1;
+        if (n == 0){
+            coeffs[0] = value_type(0);
+            return *this;
+        }
+
+        const real_type factor = real_type(2)/(upper-lower);
+        container_type d(n+2, value_type(0));
+
+        for (size_type k=n; k>0; --k)
+            d[k-1] = d[k+1] + real_type(2*k)*coeffs[k];
+        d[0] /= real_type(2);
+        d.resize(n);
+
+        for (auto &elem : d)
+            elem *= factor;
+
+        coeffs = std::move(d);
+        adjust_degree();
+        return *this;
+    }
+
+    /* Antiderivative (with respect to x) that takes the value c at the
+     * lower end of the domain: C_k = (c_{k-1} - c_{k+1})/(2k), with c_0
+     * counted twice
+     */
+    ChebyshevPolynomial& integrate (const value_type& c = value_type(0)){
+        const size_type n = coeffs.size()-1;
+        const real_type factor = (upper-lower)/real_type(2);
+        container_type r(n+2, value_type(0));
+
+        for (size_type k=1; k<=n+1; ++k){
+            const value_type prev = (k == 1) ? real_type(2)*coeffs[0] : coeffs[k-1];
+            const value_type next = (k+1 <= n) ? coeffs[k+1] : value_type(0);
+            r[k] = (prev - next)*factor/real_type(2*k);
+        }
+
+        // T_k(-1) = (-1)^k
+        value_type at_lower(0);
+        for (size_type k=1; k<=n+1; ++k)
+            at_lower += (k % 2) ? -r[k] : r[k];
+        r[0] = c - at_lower;
+
+        coeffs = std::move(r);
+        adjust_degree();
+        return *this;
+    }
+
+    friend bool operator== (const ChebyshevPolynomial& lhs, const ChebyshevPolynomial& rhs){
+        return lhs.lower == rhs.lower && lhs.upper == rhs.upper && lhs.coeffs == rhs.coeffs;
+    }
+    friend bool operator!= (const ChebyshevPolynomial& lhs, const ChebyshevPolynomial& rhs){
+        return !(lhs == rhs);
+    }
+
+private:
+    container_type coeffs;  // Chebyshev coefficients, lowest degree first
+    real_type lower;        // Domain [lower, upper]
+    real_type upper;
+    char var = 'x';         // Letter that identifies the variable
+
+    void check_domain () const{
+        if (!(lower < upper))
+            throw std::invalid_argument("fgs::ChebyshevPolynomial: empty domain");
+    }
+
+    void check_same_domain (const ChebyshevPolynomial& pol) const{
+        if (lower != pol.lower || upper != pol.upper)
+            throw std::invalid_argument("fgs::ChebyshevPolynomial: operands with different domains");
+    }
+
+    // Maps x from the domain to [-1, 1]
+    template <typename T>
+    T to_unit (const T& x) const{
+        return (T(2)*x - T(lower+upper))/T(upper-lower);
+    }
+
+    // Replaces the series with t times it: t*T_0 = T_1, t*T_k = (T_{k+1} + T_{k-1})/2
+    void multiply_by_t (){
+        const size_type n = coeffs.size();
+        container_type r(n+1, value_type(0));
+
+        r[1] += coeffs[0];
+        for (size_type k=1; k<n; ++k){
+            r[k+1] += coeffs[k]/real_type(2);
+            r[k-1] += coeffs[k]/real_type(2);
+        }
+
+        coeffs = std::move(r);
+    }
+
+    // Helper function to adjust the degree, so the last coefficient is not 0
+    void adjust_degree (){
+        while (coeffs.size() > 1 && coeffs.back() == value_type(0))
+            coeffs.pop_back();
+    }
+};
+
+template <typename CType>
+ChebyshevPolynomial<CType> operator+ (ChebyshevPolynomial<CType> lhs, const ChebyshevPolynomial<CType>& rhs){
+    return lhs += rhs;
+}
+template <typename CType>
+ChebyshevPolynomial<CType> operator- (ChebyshevPolynomial<CType> lhs, const ChebyshevPolynomial<CType>& rhs){
+    return lhs -= rhs;
+}
+template <typename CType>
+ChebyshevPolynomial<CType> operator* (ChebyshevPolynomial<CType> lhs, const ChebyshevPolynomial<CType>& rhs){
+    return lhs *= rhs;
+}
+
+// Like ChebyshevPolynomial::differentiate, but returning an rvalue
+template <typename CType>
+ChebyshevPolynomial<CType> differentiate (ChebyshevPolynomial<CType> pol){
+    return pol.differentiate();
+}
+
+// Like ChebyshevPolynomial::integrate, but returning an rvalue
+template <typename CType>
+ChebyshevPolynomial<CType> integrate (ChebyshevPolynomial<CType> pol, const CType& c = CType(0)){
+    return pol.integrate(c);
+}
+
+struct ApproximationOptions{
+    std::size_t min_degree = 16;        // Degree of the first sampling (rounded up to a power of two)
+    std::size_t max_degree = 65536;     // Degree at which the refinement stops, converged or not
+    double tolerance = 0;               // Relative size of a negligible coefficient (0 for roundoff level)
+    std::size_t threads = 0;            // Threads that sample the function (0 for one per core)
+};
+
+namespace chebyshev_aux{
+    // Fewer samples than this per thread aren't worth starting the thread
+    inline static constexpr std::size_t SAMPLES_PER_THREAD = 64;
+
+    /* Sets v[j] = f(x_j) for j = first, first+step,... being x_j the
+     * Chebyshev-Lobatto points of [a, b] (v.size()-1 is their degree). The
+     * points are spread over the threads, so f must be safe to call from
+     * several of them at once
+     */
+    template <typename T, typename Real, typename Func>
+    void sample (Func& f, std::vector<T>& v, std::size_t first, std::size_t step,
+                 Real a, Real b, std::size_t threads){
+        const std::size_t n = v.size()-1, count = (n-first)/step + 1;
+        const Real center = (a+b)/Real(2), half_width = (b-a)/Real(2), pi = std::acos(Real(-1));
+
+        // cos(pi*j/n) written as a sine, so the points are exactly symmetric
+        auto fill = [&f, &v, first, step, n, center, half_width, pi](std::size_t begin, std::size_t end){
+            for (std::size_t i=begin; i<end; ++i){
+                const std::size_t j = first + i*step;
+                const Real t = n == 0 ? Real(0) : std::sin(pi*(static_cast<Real>(n) - Real(2)*static_cast<Real>(j))/(Real(2)*static_cast<Real>(n)));
+                v[j] = T(f(center + half_width*t));
+            }
+        };
+
+        const std::size_t chunks = std::max<std::size_t>(1, std::min(threads, count/SAMPLES_PER_THREAD));
+        std::vector<std::future<void>> futures;
+        for (std::size_t k=1; k<chunks; ++k)
+            futures.push_back(std::async(std::launch::async, fill, count*k/chunks, count*(k+1)/chunks));
+
+        fill(0, count/chunks);
+        for (auto &elem : futures)
+            elem.get();
+    }
+
+    /* Number of coefficients of c worth keeping if its last quarter has
+     * decayed below tol (relative to the largest coefficient), or 0 if it
+     * hasn't and more samples are needed
+     */
+    template <typename T, typename Real>
+    std::size_t chop (const std::vector<T>& c, Real tol){
+        Real scale(0);
+        for (const auto &elem : c)
+            scale = std::max(scale, static_cast<Real>(std::abs(elem)));
+        if (scale == Real(0))
+            return 1;
+
+        const std::size_t tail = std::max<std::size_t>(1, c.size()/4);
+        for (std::size_t k=c.size()-tail; k<c.size(); ++k)
+            if (static_cast<Real>(std::abs(c[k])) > tol*scale)
+                return 0;
+
+        std::size_t ret = c.size()-tail;
+        while (ret > 1 && static_cast<Real>(std::abs(c[ret-1])) <= tol*scale)
+            --ret;
+        return ret;
+    }
+}
+
+/* Chebyshev series that approximates f on [a, b] to the working precision
+ * (or opt.tolerance). f is sampled at 2^k+1 Chebyshev-Lobatto points, the
+ * samples are turned into coefficients with a DCT in O(n log(n)), and k
+ * grows until the coefficients have decayed, reusing the samples taken so
+ * far (the points of degree n are half of those of degree 2n). Trailing
+ * negligible coefficients are dropped, so the degree is the one f needs.
+ *
+ * If f isn't smooth enough to converge by opt.max_degree, the interpolant
+ * of that degree is returned as is
+ */
+template <typename Real, typename Func,
+            typename = std::enable_if_t<std::is_floating_point_v<Real> && std::is_invocable_v<Func&, Real>>>
+auto chebyshev_approximation (Func&& f, Real a, Real b, const ApproximationOptions& opt = {}){
+    using CType = std::common_type_t<Real, std::invoke_result_t<Func&, Real>>;
+    using namespace chebyshev_aux;
+
+    const std::size_t threads = opt.threads > 0 ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t max_n = ceil_pow2(std::max<std::size_t>(1, opt.max_degree));
+    std::size_t n = std::min(ceil_pow2(std::max<std::size_t>(1, opt.min_degree)), max_n);
+
+    std::vector<CType> v(n+1);
+    sample(f, v, 0, 1, a, b, threads);
+
+    while (true){
+        // The roundoff of the samples and of the transform grows like sqrt(n)
+        const Real tol = opt.tolerance > 0 ? static_cast<Real>(opt.tolerance)
+                                           : Real(4)*std::numeric_limits<Real>::epsilon()*std::sqrt(static_cast<Real>(n));
+        const auto c = coefficients(v);
+        const std::size_t size = chop(c, tol);
+
+        if (size > 0 || n >= max_n)
+            return ChebyshevPolynomial<CType>(c.begin(), c.begin() + (size > 0 ? size : c.size()), a, b);
+
+        std::vector<CType> refined(2*n+1);
+        for (std::size_t j=0; j<=n; ++j)
+            refined[2*j] = v[j];
+        n *= 2;
+        v = std::move(refined);
+        sample(f, v, 1, 2, a, b, threads);
+    }
+}
+
+/* Like chebyshev_approximation, but in the monomial basis. Beware that
+ * the monomial coefficients of a high-degree approximation lose accuracy,
+ * which the Chebyshev form doesn't
+ */
+template <typename Real, typename Func,
+            typename = std::enable_if_t<std::is_floating_point_v<Real> && std::is_invocable_v<Func&, Real>>>
+auto polynomial_approximation (Func&& f, Real a, Real b, const ApproximationOptions& opt = {}){
+    return chebyshev_approximation(std::forward<Func>(f), a, b, opt).to_polynomial();
+}
+
+// Aliases in the style of the polynomial_* ones
+using chebyshev_float                = ChebyshevPolynomial<float>;
+using chebyshev_double               = ChebyshevPolynomial<double>;
+using chebyshev_long_double          = ChebyshevPolynomial<long double>;
+using chebyshev_complex_float        = ChebyshevPolynomial<std::complex<float>>;
+using chebyshev_complex_double       = ChebyshevPolynomial<std::complex<double>>;
+using chebyshev_complex_long_double  = ChebyshevPolynomial<std::complex<long double>>;
+
+using chebyshev = chebyshev_double;
+
+}  // namespace fgs
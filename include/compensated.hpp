@@ -0,0 +1,175 @@
+#pragma once
+
+#include "polynomial.hpp"
+
+#include <vector>       // std::vector
+#include <cmath>        // std::fma, std::abs, FP_FAST_FMA*
+#include <cstddef>      // std::size_t
+#include <limits>       // std::numeric_limits
+#include <type_traits>  // std::is_floating_point_v, std::enable_if_t, std::is_same_v
+
+/* Compensated Horner's scheme (Graillat, Langlois and Louvet)
+ *
+ * Each step of Horner's scheme rounds one product and one sum. The
+ * error-free transformations TwoProduct and TwoSum give those rounding
+ * errors exactly, and running Horner's scheme on them at the same time
+ * gives the correction of the result. The result is as accurate as if it
+ * had been computed with twice the working precision and then rounded,
+ * for about three times the cost of plain Horner (with hardware FMA), and
+ * the loops still vectorize, unlike going through long double.
+ *
+ * An a posteriori bound of the error can be computed along the way, so
+ * callers can tell when even that isn't enough and escalate. It only works
+ * for real floating-point coefficients
+ */
+namespace fgs{
+
+namespace compensated_aux{
+    template <typename T>
+    inline constexpr bool is_compensable_v = std::is_floating_point_v<T>;
+
+    // Whether std::fma is a single instruction for T (otherwise it's emulated, and slow)
+    template <typename T>
+    inline constexpr bool has_fast_fma_v =
+#ifdef FP_FAST_FMAF
+        std::is_same_v<T, float> ||
+#endif
+#ifdef FP_FAST_FMA
+        std::is_same_v<T, double> ||
+#endif
+#ifdef FP_FAST_FMAL
+        std::is_same_v<T, long double> ||
+#endif
+        false;
+
+    // Exact sum: a + b = s + e, with s = fl(a + b) (Knuth)
+    template <typename T>
+    inline void two_sum (T a, T b, T& s, T& e){
+        s = a + b;
+        const T z = s - a;
+        e = (a - (s - z)) + (b - z);
+    }
+
+    // Splits a = hi + lo, with hi and lo having half the digits of a (Veltkamp)
+    template <typename T>
+    inline void split (T a, T& hi, T& lo){
+        constexpr T factor = T((1ull << ((std::numeric_limits<T>::digits + 1)/2)) + 1);
+        const T c = factor*a;
+        hi = c - (c - a);
+        lo = a - hi;
+    }
+
+    // Exact product: a*b = p + e, with p = fl(a*b) (with an FMA, or Dekker's algorithm)
+    template <typename T>
+    inline void two_product (T a, T b, T& p, T& e){
+        p = a*b;
+        if constexpr (has_fast_fma_v<T>)
+            e = std::fma(a, b, -p);
+        else{
+            T ah, al, bh, bl;
+            split(a, ah, al);
+            split(b, bh, bl);
+            e = al*bl - (((p - ah*bh) - al*bh) - ah*bl);
+        }
+    }
+
+    // gamma(n) = n*u/(1 - n*u), being u the unit roundoff of T
+    template <typename T>
+    T gamma (std::size_t n){
+        const T nu = static_cast<T>(n)*std::numeric_limits<T>::epsilon()/T(2);
+        return nu/(T(1) - nu);
+    }
+
+    /* Bound of |res - p(x)| from the Horner's value alpha of the error
+     * terms' magnitudes at |x| (Langlois and Louvet, Theorem 4)
+     */
+    template <typename T>
+    T error_bound (T res, T alpha, std::size_t degree){
+        const T u = std::numeric_limits<T>::epsilon()/T(2);
+        return (u*std::abs(res) + (gamma<T>(4*degree + 2)*alpha + T(2)*u*u*std::abs(res)))/(T(1) - T(2)*u);
+    }
+
+    /* Compensated Horner's scheme at x. The bound is only computed (into
+     * bound) if Bound is true, so the plain version doesn't pay for it
+     */
+    template <bool Bound, typename T>
+    T evaluate (const Polynomial<T>& pol, T x, T* bound){
+        const std::size_t degree = pol.degree();
+        T s = pol[degree], c(0), alpha(0);
+
+        for (std::size_t k=degree; k>0; --k){
+            T p, pi, sigma;
+            two_product(s, x, p, pi);
+            two_sum(p, pol[k-1], s, sigma);
+            c = c*x + (pi + sigma);
+            if constexpr (Bound)
+                alpha = alpha*std::abs(x) + (std::abs(pi) + std::abs(sigma));
+        }
+
+        const T res = s + c;
+        if constexpr (Bound)
+            *bound = error_bound(res, alpha, degree);
+        return res;
+    }
+
+    // Same at the n points of x, into res (and bound)
+    template <bool Bound, typename T>
+    void evaluate (const Polynomial<T>& pol, const T* x, T* res, T* bound, std::size_t n){
+        const std::size_t degree = pol.degree();
+        std::vector<T> s(n, pol[degree]), c(n, T(0)), alpha(Bound ? n : 0, T(0));
+
+        // The points are the inner loop, so it vectorizes over them
+        for (std::size_t k=degree; k>0; --k){
+            const T a = pol[k-1];
+            for (std::size_t i=0; i<n; ++i){
+                T p, pi, sigma;
+                two_product(s[i], x[i], p, pi);
+                two_sum(p, a, s[i], sigma);
+                c[i] = c[i]*x[i] + (pi + sigma);
+                if constexpr (Bound)
+                    alpha[i] = alpha[i]*std::abs(x[i]) + (std::abs(pi) + std::abs(sigma));
+            }
+        }
+
+        for (std::size_t i=0; i<n; ++i){
+            res[i] = s[i] + c[i];
+            if constexpr (Bound)
+                bound[i] = error_bound(res[i], alpha[i], degree);
+        }
+    }
+}
+
+/* pol(x) by the compensated Horner's scheme: as accurate as Horner's
+ * scheme with twice the precision of T
+ */
+template <typename T, typename = std::enable_if_t<compensated_aux::is_compensable_v<T>>>
+T compensated_evaluate (const Polynomial<T>& pol, T x){
+    return compensated_aux::evaluate<false>(pol, x, static_cast<T*>(nullptr));
+}
+
+// Same, also setting error_bound to a bound of |pol(x) - result|
+template <typename T, typename = std::enable_if_t<compensated_aux::is_compensable_v<T>>>
+T compensated_evaluate (const Polynomial<T>& pol, T x, T& error_bound){
+    return compensated_aux::evaluate<true>(pol, x, &error_bound);
+}
+
+// pol evaluated at every point of x, by the compensated Horner's scheme
+template <typename T, typename = std::enable_if_t<compensated_aux::is_compensable_v<T>>>
+std::vector<T> compensated_evaluate (const Polynomial<T>& pol, const std::vector<T>& x){
+    std::vector<T> ret(x.size());
+    compensated_aux::evaluate<false>(pol, x.data(), ret.data(), static_cast<T*>(nullptr), x.size());
+    return ret;
+}
+
+/* Same, also writing in error_bounds (resized to x.size()) a bound of
+ * the error of each value
+ */
+template <typename T, typename = std::enable_if_t<compensated_aux::is_compensable_v<T>>>
+std::vector<T> compensated_evaluate (const Polynomial<T>& pol, const std::vector<T>& x, std::vector<T>& error_bounds){
+    std::vector<T> ret(x.size());
+    error_bounds.resize(x.size());
+    compensated_aux::evaluate<true>(pol, x.data(), ret.data(), error_bounds.data(), x.size());
+    return ret;
+}
+
+}  // namespace fgs
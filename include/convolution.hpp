@@ -0,0 +1,271 @@
+#pragma once
+
+#include "detail.hpp"
+#include "multimodular.hpp"
+#include "tuning.hpp"
+#include "instrumentation.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::min
+#include <complex>      // std::complex, std::polar, std::conj
+#include <cstddef>      // std::size_t
+#include <iterator>     // std::distance
+#include <stdexcept>    // std::overflow_error
+#include <type_traits>  // std::is_floating_point_v, std::common_type_t
+#include <utility>      // std::swap
+
+namespace fgs::convolution_aux{
+    inline static constexpr long double TWO_PI = 6.2831853071795864769L;
+
+    // Real and complex floating-point coefficients can be multiplied with the FFT (if a profile enables it)
+    template <typename T>
+    inline constexpr bool is_fft_friendly_v = std::is_floating_point_v<detail::reduce_complex_t<T>>;
+
+    // Working precision of the FFT: at least double, so float products stay accurate
+    template <typename T>
+    using fft_real_t = std::common_type_t<detail::reduce_complex_t<T>, double>;
+
+    // Copy of [first, last) as a vector of T, counted by the instrumentation
+    template <typename T, typename InputIt>
+    FGS_CONSTEXPR std::vector<T> copy_of (InputIt first, InputIt last){
+        std::vector<T> ret;
+        FGS_INSTRUMENT_ALLOCATION(ret, std::distance(first, last));
+        ret.assign(first, last);
+        return ret;
+    }
+
+    /* Low n coefficients of the schoolbook product of two coefficient
+     * sequences (lowest degree first). The high part is never computed
+     *
+     * Signed integers are accumulated in 128 bits and, like the multi-modular
+     * engine, throw std::overflow_error if a coefficient doesn't fit in T
+     * (instead of overflowing)
+     */
+    template <typename T>
+    std::vector<T> schoolbook (const std::vector<T>& a, const std::vector<T>& b, std::size_t n){
+        const std::size_t na = std::min(a.size(), n), nb = std::min(b.size(), n);
+        FGS_INSTRUMENT_FLOPS(na*nb);
+        std::vector<T> ret;
+        FGS_INSTRUMENT_ALLOCATION(ret, n);
+        ret.assign(n, T(0));
+
+#ifdef __SIZEOF_INT128__
+        if constexpr (multimodular_aux::is_supported_v<T>){
+            using multimodular_aux::int128;
+            std::vector<int128> acc(n, 0);
+            for (std::size_t i=0; i<na; ++i)
+                for (std::size_t j=0; j<nb && i+j<n; ++j)
+                    if (__builtin_add_overflow(acc[i+j], static_cast<int128>(a[i])*b[j], &acc[i+j]))
+                        throw std::overflow_error("fgs::schoolbook: result does not fit the coefficient type");
+
+            for (std::size_t k=0; k<n; ++k)
+                ret[k] = multimodular_aux::to_integer<T>(acc[k]);
+
+            return ret;
+        }
+#endif
+
+        for (std::size_t i=0; i<na; ++i)
+            for (std::size_t j=0; j<nb && i+j<n; ++j)
+                ret[i+j] += a[i]*b[j];
+
+        return ret;
+    }
+
+    /* Schoolbook product of two coefficient sequences (lowest degree first)
+     *
+     * Both sequences must be non-empty. The result has a.size()+b.size()-1
+     * coefficients
+     */
+    template <typename T>
+    std::vector<T> schoolbook (const std::vector<T>& a, const std::vector<T>& b){
+        return schoolbook(a, b, a.size()+b.size()-1);
+    }
+
+    /* In-place iterative radix-2 FFT. a.size() must be a power of two
+     *
+     * The twiddle factors are computed directly (not by repeated products),
+     * so the error doesn't grow with the size of the transform
+     */
+    template <typename Real>
+    void fft (std::vector<std::complex<Real>>& a, bool inverse){
+        const std::size_t n = a.size();
+
+        for (std::size_t i=1, j=0; i<n; ++i){
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+
+            if (i < j)
+                std::swap(a[i], a[j]);
+        }
+
+        std::vector<std::complex<Real>> roots(n/2);
+        for (std::size_t k=0; k<roots.size(); ++k)
+            roots[k] = std::polar(Real(1), (inverse ? Real(-1) : Real(1)) *
+                static_cast<Real>(TWO_PI) * static_cast<Real>(k) / static_cast<Real>(n));
+
+        for (std::size_t len=2; len<=n; len <<= 1){
+            const std::size_t step = n/len;
+            FGS_INSTRUMENT_FLOPS(n/2);
+
+            for (std::size_t i=0; i<n; i+=len)
+                for (std::size_t j=0; j<len/2; ++j){
+                    const std::complex<Real> u = a[i+j], v = a[i+j+len/2]*roots[j*step];
+                    a[i+j] = u + v;
+                    a[i+j+len/2] = u - v;
+                }
+        }
+
+        if (inverse)
+            for (auto &elem : a)
+                elem /= static_cast<Real>(n);
+    }
+
+    // Smallest power of two not lower than n
+    inline std::size_t transform_size (std::size_t n){
+        std::size_t size = 1;
+        while (size < n)
+            size <<= 1;
+        return size;
+    }
+
+    /* FFT product of two real or complex coefficient sequences
+     *
+     * Real sequences are packed into a single complex transform (a + ib), so
+     * they only need two transforms instead of three
+     */
+    template <typename T>
+    std::vector<T> fft_multiply (const std::vector<T>& a, const std::vector<T>& b){
+        using Real = fft_real_t<T>;
+        using Complex = std::complex<Real>;
+
+        const std::size_t result_size = a.size()+b.size()-1, n = transform_size(result_size);
+        std::vector<T> ret;
+        FGS_INSTRUMENT_ALLOCATION(ret, result_size);
+        ret.resize(result_size);
+
+        if constexpr (detail::is_complex_v<T>){
+            std::vector<Complex> fa, fb;
+            FGS_INSTRUMENT_ALLOCATION(fa, n);
+            FGS_INSTRUMENT_ALLOCATION(fb, n);
+            fa.resize(n);
+            fb.resize(n);
+            for (std::size_t i=0; i<a.size(); ++i)
+                fa[i] = Complex(a[i]);
+            for (std::size_t i=0; i<b.size(); ++i)
+                fb[i] = Complex(b[i]);
+
+            fft(fa, false);
+            fft(fb, false);
+            for (std::size_t i=0; i<n; ++i)
+                fa[i] *= fb[i];
+            fft(fa, true);
+
+            for (std::size_t i=0; i<result_size; ++i)
+                ret[i] = T(fa[i]);
+        }
+        else{
+            std::vector<Complex> c;
+            FGS_INSTRUMENT_ALLOCATION(c, n);
+            c.resize(n);
+            for (std::size_t i=0; i<a.size(); ++i)
+                c[i].real(static_cast<Real>(a[i]));
+            for (std::size_t i=0; i<b.size(); ++i)
+                c[i].imag(static_cast<Real>(b[i]));
+
+            fft(c, false);
+
+            // A[k]*B[k] = (C[k]^2 - conj(C[n-k])^2) / 4i
+            std::vector<Complex> p;
+            FGS_INSTRUMENT_ALLOCATION(p, n);
+            p.resize(n);
+            for (std::size_t k=0; k<n; ++k){
+                const Complex x = c[k], y = std::conj(c[(n-k) & (n-1)]);
+                p[k] = (x*x - y*y) * Complex(0, Real(-0.25));
+            }
+
+            fft(p, true);
+
+            for (std::size_t i=0; i<result_size; ++i)
+                ret[i] = T(p[i].real());
+        }
+
+        return ret;
+    }
+
+    /* Product of two coefficient sequences (lowest degree first)
+     *
+     * This is the entry point every algorithm built on top of polynomial
+     * products should use, so they all benefit from the fastest kernel
+     * available for T. Signed integers are multiplied exactly with the
+     * multi-modular engine while the result fits in 128 bits. Floating-point
+     * products only go through the FFT if the tuning profile sets their
+     * threshold (see tuning::INEXACT_DEFAULTS)
+     */
+    template <typename T>
+    std::vector<T> convolve (const std::vector<T>& a, const std::vector<T>& b){
+        const std::size_t threshold = tuning::threshold<T>(tuning::Threshold::fft);
+
+        if constexpr (is_fft_friendly_v<T>){
+            if (std::min(a.size(), b.size()) >= threshold)
+                return fft_multiply(a, b);
+        }
+        else if constexpr (detail::has_transform_multiply_v<T>){
+            if (std::min(a.size(), b.size()) >= threshold &&
+                    a.size()+b.size()-1 <= T::max_transform_size())
+                return T::transform_multiply(a, b);
+        }
+#ifdef __SIZEOF_INT128__
+        else if constexpr (multimodular_aux::is_supported_v<T>){
+            if (std::min(a.size(), b.size()) >= threshold && a.size()+b.size()-1 <= multimodular_aux::MAX_TRANSFORM_SIZE)
+                if (const auto count = multimodular_aux::primes_needed(a, b); count > 0)
+                    return multimodular_aux::multiply(a, b, count);
+        }
+#endif
+
+        return schoolbook(a, b);
+    }
+
+    /* Low n coefficients of the product of two coefficient sequences. The
+     * result has exactly n coefficients, and the high part of the product
+     * is never computed by the schoolbook kernel
+     */
+    template <typename T>
+    std::vector<T> convolve_trunc (const std::vector<T>& a, const std::vector<T>& b, std::size_t n){
+        const std::size_t na = std::min(a.size(), n), nb = std::min(b.size(), n);
+
+        if (std::min(na, nb) >= tuning::threshold<T>(tuning::Threshold::fft)){
+            auto ret = convolve(copy_of<T>(a.begin(), a.begin()+na), copy_of<T>(b.begin(), b.begin()+nb));
+            ret.resize(n, T(0));
+            return ret;
+        }
+
+        return schoolbook(a, b, n);
+    }
+
+    /* Low n coefficients of the inverse power series of a (a[0] must be
+     * invertible), by Newton's iteration g <- g*(2 - a*g), which doubles the
+     * number of correct coefficients with two truncated products
+     */
+    template <typename T>
+    std::vector<T> inverse_trunc (const std::vector<T>& a, std::size_t n){
+        if (n == 0)
+            return {};
+
+        std::vector<T> g{T(1)/a[0]};
+        for (std::size_t k=1; k<n;){
+            k = std::min(2*k, n);
+
+            auto e = convolve_trunc(a, g, k);
+            for (auto &elem : e)
+                elem = -elem;
+            e[0] += T(2);
+
+            g = convolve_trunc(g, e, k);
+        }
+
+        return g;
+    }
+}  // namespace fgs::convolution_aux
@@ -0,0 +1,117 @@
+#pragma once
+
+/* Opt-in copy-on-write storage for the coefficients of Polynomial
+ *
+ * If COPY_ON_WRITE_SUPPORT is defined before including the library, copies
+ * of a Polynomial share their coefficients (a copy only bumps an atomic
+ * reference count) until one of them is modified, and only then the one
+ * being modified gets its own buffer. Copies can be shared and released
+ * from any thread, as the shared buffer is never written.
+ *
+ * The non-const accessors that hand out references or iterators (operator[],
+ * at, first, last, begin, end,...) can't know if the reference will be
+ * written later, or after the polynomial is copied, so they detach the
+ * buffer and mark it as unshareable: from then on, copies of that
+ * polynomial are deep again. Reading through const references (or cbegin,
+ * std::as_const,...) keeps the copies cheap.
+ *
+ * If it's not defined, fgs::detail::cow_vector doesn't exist and
+ * Polynomial stores a plain std::vector
+ */
+#ifdef COPY_ON_WRITE_SUPPORT
+
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <utility>      // std::move, std::exchange
+#include <vector>       // std::vector
+
+namespace fgs::detail{
+    template <typename T>
+    class cow_vector{
+    public:
+        using container_type = std::vector<T>;
+
+        explicit cow_vector (container_type v)
+            : block(new shared{std::move(v)}) {}
+
+        cow_vector (const cow_vector& other)
+            : block(!other.block || other.block->shareable ? other.block : new shared{other.block->values})
+        {
+            if (block && block == other.block)
+                block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cow_vector (cow_vector&& other) noexcept
+            : block(std::exchange(other.block, nullptr)) {}
+
+        cow_vector& operator= (const cow_vector& other){
+            cow_vector copy(other);
+            swap(*this, copy);
+            return *this;
+        }
+
+        cow_vector& operator= (cow_vector&& other) noexcept{
+            swap(*this, other);
+            return *this;
+        }
+
+        ~cow_vector (){
+            release();
+        }
+
+        // The coefficients, for reading only
+        const container_type& read () const noexcept{
+            static const container_type empty;
+            return block ? block->values : empty;
+        }
+
+        // The coefficients, for writing (copied first if they are shared)
+        container_type& write (){
+            if (!block)
+                block = new shared{};
+            // The acquire pairs with the releases of the other owners, so their reads end before our writes
+            else if (block->references.load(std::memory_order_acquire) != 1){
+                shared* own = new shared{block->values};
+                release();
+                block = own;
+            }
+
+            return block->values;
+        }
+
+        // Like write, for references that may outlive the call: the buffer isn't shared again
+        container_type& expose (){
+            auto &ret = write();
+            block->shareable = false;
+            return ret;
+        }
+
+        // Owners of the buffer (1 if it isn't shared, 0 if moved from)
+        std::size_t use_count () const noexcept{
+            return block ? block->references.load(std::memory_order_relaxed) : 0;
+        }
+
+        friend void swap (cow_vector& lhs, cow_vector& rhs) noexcept{
+            std::swap(lhs.block, rhs.block);
+        }
+
+    private:
+        struct shared{
+            container_type values;
+            std::atomic<std::size_t> references{1};
+            bool shareable = true;  // Only cleared while references is 1
+        };
+
+        /* Null after being moved from: it reads as an empty vector (like a
+         * moved-from std::vector) and gets a buffer when it's written
+         */
+        shared* block;
+
+        void release () noexcept{
+            if (block && block->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete block;
+        }
+    };
+}  // namespace fgs::detail
+
+#endif
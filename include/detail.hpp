@@ -1,10 +1,39 @@
 #pragma once
 
 #include <complex>      // std::complex
+#include <cstddef>      // std::size_t
 #include <string>       // std::string, std::to_string
-#include <type_traits>  // std::true_type, std::false_type
+#include <type_traits>  // std::true_type, std::false_type, std::is_constant_evaluated
+#include <vector>       // std::vector
+#include <version>      // __cpp_lib_constexpr_vector, __cpp_lib_constexpr_algorithms, __cpp_lib_is_constant_evaluated
+
+/* FGS_CONSTEXPR marks the functions of Polynomial that can run in constant
+ * expressions. It's constexpr from C++20 on (where std::vector can be used
+ * at compile time), and nothing otherwise. The instrumentation counters
+ * and the shared storage of COPY_ON_WRITE_SUPPORT aren't literal types, so
+ * it's also nothing when they are enabled
+ */
+#if defined(__cpp_lib_constexpr_vector) && __cpp_lib_constexpr_vector >= 201907L && \
+    defined(__cpp_lib_constexpr_algorithms) && !defined(INSTRUMENTATION_SUPPORT) && !defined(COPY_ON_WRITE_SUPPORT)
+#define FGS_CONSTEXPR constexpr
+#define FGS_HAS_CONSTEXPR 1
+#else
+#define FGS_CONSTEXPR
+#endif
 
 namespace fgs::detail{
+    /* Whether the call happens during constant evaluation, so the dispatchers
+     * can skip the kernels that need the runtime (tuned thresholds, the FFT,
+     * threads). Always false before C++20
+     */
+    constexpr bool is_constant_evaluated () noexcept{
+#ifdef __cpp_lib_is_constant_evaluated
+        return std::is_constant_evaluated();
+#else
+        return false;
+#endif
+    }
+
     /* Function that returns any unsigned number in superscript (exponents)
      *
      * If UNICODE_SUPPORT is not enabled, it will return the string "^n"
@@ -14,25 +43,23 @@ namespace fgs::detail{
         std::string exponent;
 
 #ifdef UNICODE_SUPPORT
-        const std::string::size_type pos = (n < Integral(0))
-            ? exponent += "-", n=-n, 1
-            : 0;
+        static constexpr const char* glyphs[10] = {
+            "\u2070", "\u00B9", "\u00B2", "\u00B3", "\u2074",
+            "\u2075", "\u2076", "\u2077", "\u2078", "\u2079"
+        };
 
-        while (n > 0){
-            switch (n%10) {
-                case 0: exponent.insert(pos, "\u2070"); break;
-                case 1: exponent.insert(pos, "\u00B9"); break;
-                case 2: exponent.insert(pos, "\u00B2"); break;
-                case 3: exponent.insert(pos, "\u00B3"); break;
-                case 4: exponent.insert(pos, "\u2074"); break;
-                case 5: exponent.insert(pos, "\u2075"); break;
-                case 6: exponent.insert(pos, "\u2076"); break;
-                case 7: exponent.insert(pos, "\u2077"); break;
-                case 8: exponent.insert(pos, "\u2078"); break;
-                case 9: exponent.insert(pos, "\u2079"); break;
-            }
-            n /= 10;
+        if (n < Integral(0)){
+            exponent += "-";
+            n = -n;
         }
+
+        // Digits from the lowest, then appended from the highest
+        char digits[3*sizeof(Integral)+1];
+        std::size_t count = 0;
+        for (; n > 0; n /= 10)
+            digits[count++] = static_cast<char>(n % 10);
+        while (count > 0)
+            exponent += glyphs[static_cast<std::size_t>(digits[--count])];
 #else
         exponent = "^" + std::to_string(n);
 #endif
@@ -66,4 +93,37 @@ namespace fgs::detail{
     template<typename T>
     inline constexpr bool is_iterable_v = is_iterable<T>::value;
 
+    /* Type trait to check if a coefficient type provides its own fast product
+     * (static members transform_multiply and max_transform_size), like the
+     * number-theoretic transform of ModInt
+     */
+    template <typename T, typename = void>
+    struct has_transform_multiply : std::false_type {};
+    template <typename T>
+    struct has_transform_multiply<T, std::void_t<
+            decltype(T::transform_multiply(std::declval<const std::vector<T>&>(), std::declval<const std::vector<T>&>())),
+            decltype(T::max_transform_size())>>
+        : std::true_type {};
+    template<typename T>
+    inline constexpr bool has_transform_multiply_v = has_transform_multiply<T>::value;
+
+    // Type trait to check if T has a static member modulus (like ModInt)
+    template <typename T, typename = void>
+    struct has_modulus : std::false_type {};
+    template <typename T>
+    struct has_modulus<T, std::void_t<decltype(T::modulus)>> : std::true_type {};
+    template <typename T>
+    inline constexpr bool has_modulus_v = has_modulus<T>::value;
+
+    /* Whether k! is invertible in T for every k < n. It only fails in prime
+     * fields of characteristic up to n-1, where k! is 0 from k = P on
+     */
+    template <typename T>
+    constexpr bool factorials_invertible (std::size_t n) noexcept{
+        if constexpr (has_modulus_v<T>)
+            return n <= T::modulus;
+        else
+            return true;
+    }
+
 }  // namespace fgs::aux
@@ -0,0 +1,253 @@
+#pragma once
+
+/* Opt-in instrumentation of the hot paths of the library
+ *
+ * If INSTRUMENTATION_SUPPORT is defined before including the library, the
+ * operations count their calls, latencies (as log2 histograms), coefficient
+ * allocations and coefficient flops (multiply-adds), and Durand-Kerner
+ * counts its sweeps. Everything is kept in relaxed atomics, so it works
+ * with the threads of the product tree and the multi-modular engine.
+ *
+ * If it's not defined, the FGS_INSTRUMENT_* macros expand to nothing and
+ * fgs::instrumentation doesn't exist, so there is no cost at all
+ */
+#ifdef INSTRUMENTATION_SUPPORT
+
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <chrono>       // std::chrono::steady_clock
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <functional>   // std::function
+#include <mutex>        // std::mutex, std::lock_guard, std::unique_lock
+#include <ostream>      // std::basic_ostream
+#include <utility>      // std::move
+
+namespace fgs::instrumentation{
+    // Instrumented operations
+    enum class Operation : std::size_t{
+        addition, substraction, multiplication, division, modulus,
+        evaluation, composition, gcd, roots, count
+    };
+
+    inline static constexpr std::size_t OPERATIONS = static_cast<std::size_t>(Operation::count);
+
+    // Bucket k of a latency histogram holds the calls that took [2^k, 2^(k+1)) ns
+    inline static constexpr std::size_t HISTOGRAM_BUCKETS = 40;
+
+    inline const char* operation_name (Operation op){
+        static constexpr std::array<const char*, OPERATIONS> names = {
+            "addition", "substraction", "multiplication", "division", "modulus",
+            "evaluation", "composition", "gcd", "roots"
+        };
+        return names[static_cast<std::size_t>(op)];
+    }
+
+    struct OperationStats{
+        std::uint64_t calls = 0;
+        std::uint64_t nanoseconds = 0;  // Total time spent in the calls
+        std::array<std::uint64_t, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    // Snapshot of every counter
+    struct Stats{
+        std::uint64_t allocations = 0;              // Coefficient buffers allocated or grown
+        std::uint64_t allocated_coefficients = 0;   // Coefficients those buffers hold
+        std::uint64_t flops = 0;                    // Coefficient multiply-adds
+        std::uint64_t durand_kerner_calls = 0;
+        std::uint64_t durand_kerner_iterations = 0; // Sweeps over every root
+        std::array<OperationStats, OPERATIONS> operations{};
+
+        const OperationStats& operator[] (Operation op) const{ return operations[static_cast<std::size_t>(op)]; }
+    };
+
+    namespace detail{
+        struct AtomicOperationStats{
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> nanoseconds{0};
+            std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS> histogram{};
+        };
+
+        struct Registry{
+            std::atomic<std::uint64_t> allocations{0};
+            std::atomic<std::uint64_t> allocated_coefficients{0};
+            std::atomic<std::uint64_t> flops{0};
+            std::atomic<std::uint64_t> durand_kerner_calls{0};
+            std::atomic<std::uint64_t> durand_kerner_iterations{0};
+            std::array<AtomicOperationStats, OPERATIONS> operations{};
+
+            std::mutex hook_mutex;
+            std::atomic<bool> has_hook{false};
+            std::function<void(const Stats&)> hook;
+            std::chrono::steady_clock::duration period{};
+            std::chrono::steady_clock::time_point last_dump{};
+        };
+
+        inline Registry& registry (){
+            static Registry r;
+            return r;
+        }
+
+        inline void add (std::atomic<std::uint64_t>& counter, std::uint64_t n){
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        inline std::size_t bucket (std::uint64_t ns){
+            std::size_t k = 0;
+            for (; ns > 1 && k+1 < HISTOGRAM_BUCKETS; ns >>= 1)
+                ++k;
+            return k;
+        }
+    }
+
+    // Current value of every counter
+    inline Stats stats (){
+        auto &r = detail::registry();
+        Stats ret;
+
+        ret.allocations = r.allocations.load(std::memory_order_relaxed);
+        ret.allocated_coefficients = r.allocated_coefficients.load(std::memory_order_relaxed);
+        ret.flops = r.flops.load(std::memory_order_relaxed);
+        ret.durand_kerner_calls = r.durand_kerner_calls.load(std::memory_order_relaxed);
+        ret.durand_kerner_iterations = r.durand_kerner_iterations.load(std::memory_order_relaxed);
+
+        for (std::size_t i=0; i<OPERATIONS; ++i){
+            ret.operations[i].calls = r.operations[i].calls.load(std::memory_order_relaxed);
+            ret.operations[i].nanoseconds = r.operations[i].nanoseconds.load(std::memory_order_relaxed);
+            for (std::size_t k=0; k<HISTOGRAM_BUCKETS; ++k)
+                ret.operations[i].histogram[k] = r.operations[i].histogram[k].load(std::memory_order_relaxed);
+        }
+
+        return ret;
+    }
+
+    // Sets every counter to zero
+    inline void reset (){
+        auto &r = detail::registry();
+
+        for (auto *counter : {&r.allocations, &r.allocated_coefficients, &r.flops,
+                              &r.durand_kerner_calls, &r.durand_kerner_iterations})
+            counter->store(0, std::memory_order_relaxed);
+
+        for (auto &op : r.operations){
+            op.calls.store(0, std::memory_order_relaxed);
+            op.nanoseconds.store(0, std::memory_order_relaxed);
+            for (auto &elem : op.histogram)
+                elem.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /* Calls hook with the current stats at most once per period. The check
+     * is done when an instrumented operation ends, so no thread is started.
+     * An empty hook disables the dumps
+     */
+    template <typename Rep, typename Period>
+    void set_dump_hook (std::function<void(const Stats&)> hook, std::chrono::duration<Rep, Period> period){
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.hook_mutex);
+
+        r.has_hook.store(static_cast<bool>(hook), std::memory_order_relaxed);
+        r.hook = std::move(hook);
+        r.period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+        r.last_dump = std::chrono::steady_clock::now();
+    }
+
+    // Human-readable summary of the stats
+    template <typename charT, typename traits>
+    std::basic_ostream<charT, traits>& operator<< (std::basic_ostream<charT, traits>& os, const Stats& s){
+        os << "allocations: " << s.allocations << " (" << s.allocated_coefficients << " coefficients)\n"
+           << "flops: " << s.flops << "\n"
+           << "durand-kerner: " << s.durand_kerner_calls << " calls, "
+           << s.durand_kerner_iterations << " iterations\n";
+
+        for (std::size_t i=0; i<OPERATIONS; ++i)
+            if (s.operations[i].calls > 0)
+                os << operation_name(static_cast<Operation>(i)) << ": " << s.operations[i].calls << " calls, "
+                   << s.operations[i].nanoseconds/s.operations[i].calls << " ns/call\n";
+
+        return os;
+    }
+
+    namespace detail{
+        inline void maybe_dump (){
+            // The hook may use instrumented operations, which must not dump again
+            thread_local bool in_hook = false;
+
+            auto &r = registry();
+            if (in_hook || !r.has_hook.load(std::memory_order_relaxed))
+                return;
+
+            std::unique_lock<std::mutex> lock(r.hook_mutex, std::try_to_lock);
+            if (!lock || !r.hook)
+                return;
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - r.last_dump < r.period)
+                return;
+
+            r.last_dump = now;
+            in_hook = true;
+            r.hook(stats());
+            in_hook = false;
+        }
+
+        // Counts a call to op and its latency, from construction to destruction
+        class ScopedTimer{
+        public:
+            explicit ScopedTimer (Operation o)
+                : op(static_cast<std::size_t>(o)), start(std::chrono::steady_clock::now()) {}
+
+            ScopedTimer (const ScopedTimer&) = delete;
+            ScopedTimer& operator= (const ScopedTimer&) = delete;
+
+            ~ScopedTimer (){
+                const auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                auto &entry = registry().operations[op];
+
+                add(entry.calls, 1);
+                add(entry.nanoseconds, ns);
+                add(entry.histogram[bucket(ns)], 1);
+                maybe_dump();
+            }
+
+        private:
+            std::size_t op;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        // Counts an allocation if storing n coefficients in c needs one
+        template <typename Container>
+        void note_allocation (const Container& c, std::size_t n){
+            if (n > c.capacity()){
+                add(registry().allocations, 1);
+                add(registry().allocated_coefficients, n);
+            }
+        }
+    }
+}  // namespace fgs::instrumentation
+
+#define FGS_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define FGS_INSTRUMENT_CONCAT(a, b) FGS_INSTRUMENT_CONCAT_IMPL(a, b)
+
+#define FGS_INSTRUMENT_SCOPE(op) \
+    const ::fgs::instrumentation::detail::ScopedTimer FGS_INSTRUMENT_CONCAT(fgs_instrument_timer_, __LINE__)( \
+        ::fgs::instrumentation::Operation::op)
+#define FGS_INSTRUMENT_ALLOCATION(container, n) \
+    ::fgs::instrumentation::detail::note_allocation((container), static_cast<std::size_t>(n))
+#define FGS_INSTRUMENT_FLOPS(n) \
+    ::fgs::instrumentation::detail::add(::fgs::instrumentation::detail::registry().flops, static_cast<std::uint64_t>(n))
+#define FGS_INSTRUMENT_ROOT_CALL() \
+    ::fgs::instrumentation::detail::add(::fgs::instrumentation::detail::registry().durand_kerner_calls, 1)
+#define FGS_INSTRUMENT_ROOT_ITERATION() \
+    ::fgs::instrumentation::detail::add(::fgs::instrumentation::detail::registry().durand_kerner_iterations, 1)
+
+#else
+
+#define FGS_INSTRUMENT_SCOPE(op) static_cast<void>(0)
+#define FGS_INSTRUMENT_ALLOCATION(container, n) static_cast<void>(0)
+#define FGS_INSTRUMENT_FLOPS(n) static_cast<void>(0)
+#define FGS_INSTRUMENT_ROOT_CALL() static_cast<void>(0)
+#define FGS_INSTRUMENT_ROOT_ITERATION() static_cast<void>(0)
+
+#endif
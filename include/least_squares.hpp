@@ -0,0 +1,205 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "chebyshev.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::max
+#include <cmath>        // std::sqrt, std::abs
+#include <cstddef>      // std::size_t
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::invalid_argument, std::domain_error
+#include <type_traits>  // std::is_floating_point_v
+
+/* Streaming least-squares fitting of polynomials
+ *
+ * LeastSquaresFitter takes the samples one at a time and keeps the upper
+ * triangular factor R of the QR factorization of the design matrix (and
+ * Q^T*y), updated with Givens rotations. Its memory is O(degree^2) however
+ * many samples are added, and each sample costs O(degree^2). The design
+ * matrix is written in the Chebyshev basis of the interval of the data, so
+ * it stays well conditioned at high degrees (the monomial basis, like the
+ * normal equations, loses about twice as many digits).
+ *
+ * The factor of a set of samples is also a set of samples (its rows), so
+ * fitters fed from different threads are merged by rotating the rows of one
+ * into the other, and the result is the fit of all the samples
+ */
+namespace fgs{
+
+// Result of a least-squares fit and its residual statistics
+template <typename T>
+struct LeastSquaresFit{
+    Polynomial<T> polynomial;           // Fitted polynomial (monomial basis)
+    ChebyshevPolynomial<T> chebyshev;   // Same polynomial, in the basis it was solved in
+    std::size_t count = 0;              // Samples fitted
+    T residual_sum_of_squares = T(0);   // Weighted sum of the squared residuals
+    T rms_residual = T(0);              // sqrt(residual_sum_of_squares/sum of the weights)
+    T r_squared = T(1);                 // Coefficient of determination (1 if the data is constant)
+};
+
+template <typename T>
+class LeastSquaresFitter{
+    static_assert(std::is_floating_point_v<T>, "LeastSquaresFitter needs real floating-point coefficients");
+
+public:
+    using value_type    = T;
+    using size_type     = std::size_t;
+
+    /* Fitter of a polynomial of degree n to samples taken from [a, b].
+     * Samples outside of [a, b] are valid, but the conditioning worsens
+     * quickly the further they are
+     */
+    LeastSquaresFitter (size_type n, T a, T b)
+        : n_coeffs(n+1), lower(a), upper(b), r(n_coeffs*n_coeffs, T(0)), qty(n_coeffs, T(0)), row(n_coeffs)
+    {
+        if (!(lower < upper))
+            throw std::invalid_argument("fgs::LeastSquaresFitter: empty domain");
+    }
+
+    // Adds the sample (x, y), with weight w
+    void add (T x, T y, T w = T(1)){
+        if (w == T(0))
+            return;
+
+        // sqrt(w)*T_k(t), being t the image of x in [-1, 1]
+        const T t = (T(2)*x - (lower+upper))/(upper-lower), s = std::sqrt(w);
+        row[0] = s;
+        if (n_coeffs > 1)
+            row[1] = s*t;
+        for (size_type k=2; k<n_coeffs; ++k)
+            row[k] = T(2)*t*row[k-1] - row[k-2];
+
+        rotate_in(0, s*y);
+        update_statistics(1, w, y, T(0));
+    }
+
+    // Adds the samples (x[i], y[i]), with unit weights
+    void add (const std::vector<T>& x, const std::vector<T>& y){
+        if (x.size() != y.size())
+            throw std::invalid_argument("fgs::LeastSquaresFitter: different number of abscissas and ordinates");
+
+        for (size_type i=0; i<x.size(); ++i)
+            add(x[i], y[i]);
+    }
+
+    /* Adds every sample of other, which must have the same degree and
+     * interval. The result is the same as adding them here (up to rounding)
+     */
+    LeastSquaresFitter& merge (const LeastSquaresFitter& other){
+        if (n_coeffs != other.n_coeffs || lower != other.lower || upper != other.upper)
+            throw std::invalid_argument("fgs::LeastSquaresFitter: merging fitters of different degrees or domains");
+        if (&other == this){
+            const LeastSquaresFitter copy(other);
+            return merge(copy);
+        }
+
+        // Row k of other's factor starts at column k
+        for (size_type k=0; k<n_coeffs; ++k){
+            std::copy(other.r.begin() + k*n_coeffs + k, other.r.begin() + (k+1)*n_coeffs, row.begin() + k);
+            rotate_in(k, other.qty[k]);
+        }
+
+        rss += other.rss;
+        update_statistics(other.samples, other.weight, other.mean, other.m2);
+        return *this;
+    }
+
+    size_type degree () const noexcept{ return n_coeffs-1; }
+    size_type count () const noexcept{ return samples; }
+
+    T lower_bound () const noexcept{ return lower; }
+    T upper_bound () const noexcept{ return upper; }
+
+    /* Fit of the samples added so far, by back substitution on the factor.
+     * Throws std::domain_error if the samples don't determine a polynomial
+     * of the degree (fewer distinct abscissas than coefficients)
+     */
+    LeastSquaresFit<T> fit () const{
+        T largest(0);
+        for (size_type k=0; k<n_coeffs; ++k)
+            largest = std::max(largest, std::abs(r[k*n_coeffs+k]));
+
+        const T tiny = largest*T(n_coeffs)*std::numeric_limits<T>::epsilon();
+        std::vector<T> c(n_coeffs);
+        for (size_type k=n_coeffs; k-- > 0;){
+            const T pivot = r[k*n_coeffs+k];
+            if (!(std::abs(pivot) > tiny))
+                throw std::domain_error("fgs::LeastSquaresFitter: not enough distinct samples for the degree");
+
+            T sum = qty[k];
+            for (size_type j=k+1; j<n_coeffs; ++j)
+                sum -= r[k*n_coeffs+j]*c[j];
+            c[k] = sum/pivot;
+        }
+
+        LeastSquaresFit<T> ret{Polynomial<T>(), ChebyshevPolynomial<T>(c.begin(), c.end(), lower, upper),
+                               samples, rss, std::sqrt(rss/weight), T(1)};
+        ret.polynomial = ret.chebyshev.to_polynomial();
+        if (m2 > T(0))
+            ret.r_squared = T(1) - rss/m2;
+        return ret;
+    }
+
+private:
+    size_type n_coeffs;     // Degree plus one
+    T lower;                // Interval [lower, upper] mapped to [-1, 1]
+    T upper;
+
+    std::vector<T> r;       // Upper triangular factor, row-major
+    std::vector<T> qty;     // Q^T*y
+    std::vector<T> row;     // Row being rotated in
+    T rss = T(0);           // Residual sum of squares
+
+    // Weighted mean and sum of squared deviations of y (Welford), for r_squared
+    size_type samples = 0;
+    T weight = T(0);
+    T mean = T(0);
+    T m2 = T(0);
+
+    /* Rotates row (zero before column first) and its right-hand side into
+     * the factor. Whatever is left of the right-hand side can't be fitted,
+     * so it goes to the residual
+     */
+    void rotate_in (size_type first, T rhs){
+        for (size_type k=first; k<n_coeffs; ++k){
+            if (row[k] == T(0))
+                continue;
+
+            T* rk = r.data() + k*n_coeffs;
+            if (rk[k] == T(0)){
+                std::copy(row.begin()+k, row.end(), rk+k);
+                qty[k] = rhs;
+                return;
+            }
+
+            const T h = std::sqrt(rk[k]*rk[k] + row[k]*row[k]), c = rk[k]/h, s = row[k]/h;
+            rk[k] = h;
+            for (size_type j=k+1; j<n_coeffs; ++j){
+                const T u = rk[j];
+                rk[j] = c*u + s*row[j];
+                row[j] = c*row[j] - s*u;
+            }
+
+            const T u = qty[k];
+            qty[k] = c*u + s*rhs;
+            rhs = c*rhs - s*u;
+        }
+
+        rss += rhs*rhs;
+    }
+
+    // Merges n samples of total weight w, mean m and sum of squared deviations d (Chan et al.)
+    void update_statistics (size_type n, T w, T m, T d){
+        if (w == T(0))
+            return;
+
+        const T total = weight + w, delta = m - mean;
+        mean += delta*w/total;
+        m2 += d + delta*delta*weight*w/total;
+        weight = total;
+        samples += n;
+    }
+};
+
+}  // namespace fgs
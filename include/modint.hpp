@@ -0,0 +1,265 @@
+#pragma once
+
+#include "instrumentation.hpp"
+
+#include <cstdint>      // std::uint32_t, std::uint64_t, std::int64_t
+#include <cstddef>      // std::size_t
+#include <vector>       // std::vector
+#include <ostream>      // std::basic_ostream
+#include <type_traits>  // std::enable_if_t, std::is_integral_v, std::is_signed_v
+#include <utility>      // std::swap
+
+namespace fgs{
+
+namespace modint_aux{
+    // x^e mod m, usable in constant expressions
+    constexpr std::uint32_t power_mod (std::uint64_t x, std::uint64_t e, std::uint32_t m){
+        std::uint64_t ret = 1;
+        for (x %= m; e > 0; e >>= 1){
+            if (e & 1)
+                ret = ret*x % m;
+            x = x*x % m;
+        }
+        return static_cast<std::uint32_t>(ret);
+    }
+
+    // Smallest primitive root modulo the prime p
+    constexpr std::uint32_t primitive_root (std::uint32_t p){
+        if (p == 2)
+            return 1;
+
+        // Prime factors of p-1 (at most 9 distinct ones below 2^32)
+        std::uint32_t factors[10] = {}, n = p-1;
+        std::size_t count = 0;
+        for (std::uint32_t q=2; static_cast<std::uint64_t>(q)*q <= n; ++q)
+            if (n%q == 0){
+                factors[count++] = q;
+                while (n%q == 0)
+                    n /= q;
+            }
+        if (n > 1)
+            factors[count++] = n;
+
+        for (std::uint32_t g=2;; ++g){
+            bool ok = true;
+            for (std::size_t i=0; i<count && ok; ++i)
+                ok = power_mod(g, (p-1)/factors[i], p) != 1;
+            if (ok)
+                return g;
+        }
+    }
+
+    // Exponent of the largest power of two dividing n
+    constexpr unsigned two_adicity (std::uint32_t n){
+        unsigned k = 0;
+        for (; n%2 == 0; n /= 2)
+            ++k;
+        return k;
+    }
+}
+
+/* Class ModInt. Integers modulo the prime P, which makes them a field, so
+ * polynomials over them meet every requirement of Polynomial and all of
+ * their arithmetic (gcd, division, remainder...) is exact.
+ *
+ * Values are stored in Montgomery form (x*2^32 mod P), so products are
+ * reduced with a multiplication and a shift instead of a division. P must
+ * be an odd prime lower than 2^31.
+ *
+ * If P-1 is divisible by a large power of two (as in 998244353 = 119*2^23+1),
+ * products of polynomials are computed with the number-theoretic transform
+ * (see transform_multiply), which convolution_aux::convolve selects
+ * automatically
+ */
+template <std::uint32_t P>
+class ModInt{
+    static_assert(P % 2 == 1 && P < (std::uint32_t(1) << 31), "P must be an odd prime lower than 2^31");
+
+public:
+    static constexpr std::uint32_t modulus = P;
+
+    constexpr ModInt () noexcept
+        : v(0) {}
+
+    template <typename Integral, typename = std::enable_if_t<std::is_integral_v<Integral>>>
+    constexpr ModInt (Integral x) noexcept     // NOLINT(google-explicit-constructor)
+        : v(to_montgomery(normalize(x))) {}
+
+    // Representative of the value in [0, P)
+    constexpr std::uint32_t value () const noexcept{ return reduce(v); }
+
+    constexpr ModInt operator+ () const noexcept{ return *this; }
+    constexpr ModInt operator- () const noexcept{ return from_raw(v == 0 ? 0 : P - v); }
+
+    constexpr ModInt& operator+= (const ModInt& rhs) noexcept{
+        v += rhs.v;
+        if (v >= P)
+            v -= P;
+        return *this;
+    }
+    constexpr ModInt& operator-= (const ModInt& rhs) noexcept{
+        v = (v >= rhs.v) ? v - rhs.v : v + P - rhs.v;
+        return *this;
+    }
+    constexpr ModInt& operator*= (const ModInt& rhs) noexcept{
+        v = reduce(static_cast<std::uint64_t>(v)*rhs.v);
+        return *this;
+    }
+    constexpr ModInt& operator/= (const ModInt& rhs) noexcept{
+        return *this *= rhs.inverse();
+    }
+
+    friend constexpr ModInt operator+ (ModInt lhs, const ModInt& rhs) noexcept{ return lhs += rhs; }
+    friend constexpr ModInt operator- (ModInt lhs, const ModInt& rhs) noexcept{ return lhs -= rhs; }
+    friend constexpr ModInt operator* (ModInt lhs, const ModInt& rhs) noexcept{ return lhs *= rhs; }
+    friend constexpr ModInt operator/ (ModInt lhs, const ModInt& rhs) noexcept{ return lhs /= rhs; }
+
+    friend constexpr bool operator== (const ModInt& lhs, const ModInt& rhs) noexcept{ return lhs.v == rhs.v; }
+    friend constexpr bool operator!= (const ModInt& lhs, const ModInt& rhs) noexcept{ return lhs.v != rhs.v; }
+
+    // x^e by binary exponentiation
+    constexpr ModInt pow (std::uint64_t e) const noexcept{
+        ModInt ret(1), x(*this);
+
+        for (; e > 0; e >>= 1){
+            if (e & 1)
+                ret *= x;
+            x *= x;
+        }
+
+        return ret;
+    }
+
+    // Multiplicative inverse by Fermat's little theorem (undefined for 0)
+    constexpr ModInt inverse () const noexcept{ return pow(P-2); }
+
+    // Largest transform length (a power of two) the NTT supports for P
+    static constexpr std::size_t max_transform_size () noexcept{
+        return std::size_t(1) << modint_aux::two_adicity(P-1);
+    }
+
+    // Product of two coefficient sequences with the number-theoretic transform
+    static std::vector<ModInt> transform_multiply (const std::vector<ModInt>& a, const std::vector<ModInt>& b){
+        const std::size_t result_size = a.size()+b.size()-1;
+        std::size_t n = 1;
+        while (n < result_size)
+            n <<= 1;
+
+        std::vector<ModInt> fa(a), fb(b);
+        fa.resize(n);
+        fb.resize(n);
+
+        ntt(fa, false);
+        ntt(fb, false);
+        for (std::size_t i=0; i<n; ++i)
+            fa[i] *= fb[i];
+        ntt(fa, true);
+
+        fa.resize(result_size);
+        return fa;
+    }
+
+    /* In-place iterative radix-2 NTT. a.size() must be a power of two not
+     * greater than max_transform_size(). Everything stays in Montgomery form,
+     * as the transform is linear
+     */
+    static void ntt (std::vector<ModInt>& a, bool inverse){
+        const std::size_t n = a.size();
+
+        for (std::size_t i=1, j=0; i<n; ++i){
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+
+            if (i < j)
+                std::swap(a[i], a[j]);
+        }
+
+        ModInt w = ModInt(ROOT).pow((P-1)/n);
+        if (inverse)
+            w = w.inverse();
+
+        std::vector<ModInt> roots(n/2);
+        if (!roots.empty())
+            roots[0] = ModInt(1);
+        for (std::size_t k=1; k<roots.size(); ++k)
+            roots[k] = roots[k-1]*w;
+
+        for (std::size_t len=2; len<=n; len <<= 1){
+            const std::size_t step = n/len;
+            FGS_INSTRUMENT_FLOPS(n/2);
+
+            for (std::size_t i=0; i<n; i+=len)
+                for (std::size_t j=0; j<len/2; ++j){
+                    const ModInt u = a[i+j], t = a[i+j+len/2]*roots[j*step];
+                    a[i+j] = u + t;
+                    a[i+j+len/2] = u - t;
+                }
+        }
+
+        if (inverse){
+            const ModInt n_inverse = ModInt(n).inverse();
+            for (auto &elem : a)
+                elem *= n_inverse;
+        }
+    }
+
+    template <typename charT, typename traits>
+    friend std::basic_ostream<charT, traits>&
+    operator<< (std::basic_ostream<charT, traits> &os, const ModInt& x){
+        // Signed, so std::showpos behaves as with the floating-point types
+        return os << static_cast<std::int64_t>(x.value());
+    }
+
+private:
+    std::uint32_t v;    // Montgomery form of the value
+
+    static constexpr std::uint32_t ROOT = modint_aux::primitive_root(P);
+
+    // -P^(-1) mod 2^32, by Newton's iteration (each step doubles the correct bits)
+    static constexpr std::uint32_t neg_inverse (){
+        std::uint32_t x = P;
+        for (int i=0; i<5; ++i)
+            x *= 2u - P*x;
+        return ~x + 1u;
+    }
+
+    static constexpr std::uint32_t N_PRIME = neg_inverse();
+    // 2^64 mod P, which takes a value to Montgomery form in one reduction
+    static constexpr std::uint32_t R2 = static_cast<std::uint32_t>(-static_cast<std::uint64_t>(P) % P);
+
+    // Montgomery reduction: x*2^(-32) mod P, for x < P*2^32
+    static constexpr std::uint32_t reduce (std::uint64_t x) noexcept{
+        const std::uint32_t m = static_cast<std::uint32_t>(x)*N_PRIME;
+        const std::uint32_t t = static_cast<std::uint32_t>((x + static_cast<std::uint64_t>(m)*P) >> 32);
+        return (t >= P) ? t - P : t;
+    }
+
+    static constexpr std::uint32_t to_montgomery (std::uint32_t x) noexcept{
+        return reduce(static_cast<std::uint64_t>(x)*R2);
+    }
+
+    template <typename Integral>
+    static constexpr std::uint32_t normalize (Integral x) noexcept{
+        if constexpr (std::is_signed_v<Integral>){
+            const long long r = static_cast<long long>(x) % static_cast<long long>(P);
+            return static_cast<std::uint32_t>(r < 0 ? r + P : r);
+        }
+        else
+            return static_cast<std::uint32_t>(static_cast<unsigned long long>(x) % P);
+    }
+
+    static constexpr ModInt from_raw (std::uint32_t raw) noexcept{
+        ModInt ret;
+        ret.v = raw;
+        return ret;
+    }
+};
+
+// The usual NTT-friendly primes
+using modint_998244353 = ModInt<998244353>;    // 119*2^23 + 1
+using modint_167772161 = ModInt<167772161>;    // 5*2^25 + 1
+using modint_469762049 = ModInt<469762049>;    // 7*2^26 + 1
+
+}  // namespace fgs
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "modint.hpp"
+
+#include <algorithm>    // std::max, std::min
+#include <array>        // std::array
+#include <cmath>        // std::log2, std::sqrt
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstddef>      // std::size_t
+#include <future>       // std::async, std::future
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::overflow_error
+#include <type_traits>  // std::integral_constant, std::is_signed_v
+#include <utility>      // std::index_sequence
+#include <vector>       // std::vector
+
+/* Multi-modular (CRT) engine for exact arithmetic over the integers
+ *
+ * Integer data is mapped to several NTT-friendly primes below 2^31, each
+ * prime is processed on its own thread with ModInt arithmetic, and the
+ * results are put back together with the Chinese remainder theorem
+ * (Garner's algorithm) and, when the result is rational, rational
+ * reconstruction. Everything fits in 128-bit integers, so no big-integer
+ * dependency is needed: up to 4 primes are combined, which covers results
+ * of about 120 bits.
+ *
+ * Needs a compiler with __int128 (GCC and Clang)
+ */
+namespace fgs::multimodular_aux{
+    // Coefficient types handled by the multi-modular engine: signed integers up to 64 bits
+    template <typename T>
+    inline constexpr bool is_supported_v =
+#ifdef __SIZEOF_INT128__
+        std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= 8;
+#else
+        false;
+#endif
+}  // namespace fgs::multimodular_aux
+
+#ifdef __SIZEOF_INT128__
+namespace fgs::multimodular_aux{
+    __extension__ typedef __int128 int128;
+    __extension__ typedef unsigned __int128 uint128;
+
+    // NTT-friendly primes below 2^31, sorted by the length of the transform they support
+    inline constexpr std::array<std::uint32_t, 8> PRIMES = {
+        2013265921, // 15*2^27 + 1
+        1811939329, // 27*2^26 + 1
+        2113929217, // 63*2^25 + 1
+        1711276033, // 51*2^25 + 1
+        2130706433, // 127*2^24 + 1
+        1224736769, // 73*2^24 + 1
+        2088763393, // 249*2^23 + 1
+        1484783617  // 177*2^23 + 1
+    };
+
+    // Number of primes whose product still fits (with a sign bit to spare) in 128 bits
+    inline static constexpr std::size_t MAX_COMBINED_PRIMES = 4;
+
+    // Residue of an integer modulo p, in [0, p)
+    inline std::uint32_t residue (int128 x, std::uint32_t p){
+        const int128 r = x % static_cast<int128>(p);
+        return static_cast<std::uint32_t>(r < 0 ? r + p : r);
+    }
+
+    // x^(-1) mod p for p prime
+    inline std::uint32_t inverse_mod (std::uint32_t x, std::uint32_t p){
+        return modint_aux::power_mod(x, p-2, p);
+    }
+
+    inline uint128 magnitude (int128 x){
+        return x < 0 ? static_cast<uint128>(0) - static_cast<uint128>(x) : static_cast<uint128>(x);
+    }
+
+    inline int128 gcd (int128 a, int128 b){
+        a = static_cast<int128>(magnitude(a));
+        b = static_cast<int128>(magnitude(b));
+        while (b != 0){
+            const int128 t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    /* Calls fn(std::integral_constant<std::uint32_t, PRIMES[i]>{}), turning
+     * the runtime index into the compile-time prime ModInt needs
+     */
+    template <typename Fn, std::size_t... I>
+    auto call_with_prime (std::size_t i, Fn& fn, std::index_sequence<I...>){
+        decltype(fn(std::integral_constant<std::uint32_t, PRIMES[0]>{})) ret{};
+        ((i == I ? (void)(ret = fn(std::integral_constant<std::uint32_t, PRIMES[I]>{})) : void()), ...);
+        return ret;
+    }
+
+    /* Results of fn for the primes PRIMES[first], ..., PRIMES[first+count-1],
+     * one thread per prime
+     */
+    template <typename Fn>
+    auto map_primes (std::size_t first, std::size_t count, Fn fn){
+        using Indices = std::make_index_sequence<PRIMES.size()>;
+        using Result = decltype(call_with_prime(0, fn, Indices{}));
+
+        std::vector<std::future<Result>> futures;
+        for (std::size_t i=first+1; i<first+count; ++i)
+            futures.push_back(std::async(std::launch::async, [&fn, i](){
+                return call_with_prime(i, fn, Indices{});
+            }));
+
+        std::vector<Result> ret;
+        ret.reserve(count);
+        if (count > 0)
+            ret.push_back(call_with_prime(first, fn, Indices{}));
+        for (auto &f : futures)
+            ret.push_back(f.get());
+
+        return ret;
+    }
+
+    /* Incremental Chinese remainder theorem (Garner's algorithm): keeps the
+     * value in [0, modulus) congruent to every residue added so far
+     */
+    struct crt_accumulator{
+        uint128 value = 0;
+        uint128 modulus = 1;
+
+        void add (std::uint32_t r, std::uint32_t p){
+            const std::uint32_t current = static_cast<std::uint32_t>(value % p);
+            const std::uint64_t diff = (static_cast<std::uint64_t>(r) + p - current) % p;
+            const std::uint64_t t = diff * inverse_mod(static_cast<std::uint32_t>(modulus % p), p) % p;
+
+            value += static_cast<uint128>(t) * modulus;
+            modulus *= p;
+        }
+
+        // Representative in (-modulus/2, modulus/2]
+        int128 symmetric () const{
+            return (value > modulus/2) ? -static_cast<int128>(modulus - value) : static_cast<int128>(value);
+        }
+    };
+
+    /* Rational reconstruction: the fraction num/den congruent to the value
+     * of acc with |num|, den <= sqrt(modulus/2), if there is one
+     */
+    inline bool rational_reconstruction (const crt_accumulator& acc, int128& num, int128& den){
+        const uint128 half = acc.modulus/2;
+        uint128 bound = static_cast<uint128>(std::sqrt(static_cast<long double>(half)));
+        while (bound*bound > half)
+            --bound;
+        while ((bound+1)*(bound+1) <= half)
+            ++bound;
+
+        int128 r0 = static_cast<int128>(acc.modulus), r1 = static_cast<int128>(acc.value), s0 = 0, s1 = 1;
+        while (static_cast<uint128>(r1) > bound){
+            const int128 q = r0/r1, r2 = r0 - q*r1, s2 = s0 - q*s1;
+            r0 = r1; r1 = r2;
+            s0 = s1; s1 = s2;
+        }
+
+        if (s1 == 0 || magnitude(s1) > bound || gcd(r1, s1) != 1)
+            return false;
+
+        num = (s1 < 0) ? -r1 : r1;
+        den = (s1 < 0) ? -s1 : s1;
+        return true;
+    }
+
+    // Longest product every combined prime can transform (2^25, from PRIMES[3])
+    inline static constexpr std::size_t MAX_TRANSFORM_SIZE = std::size_t(1) << 25;
+
+    /* Number of primes needed to recover a.b exactly, from the bound
+     * min(|a|,|b|)*max|a_i|*max|b_j| of its coefficients. 0 if that needs
+     * more than 128 bits
+     */
+    template <typename T>
+    std::size_t primes_needed (const std::vector<T>& a, const std::vector<T>& b){
+        long double max_a = 0.0L, max_b = 0.0L;
+        for (const auto &elem : a)
+            max_a = std::max(max_a, static_cast<long double>(magnitude(elem)));
+        for (const auto &elem : b)
+            max_b = std::max(max_b, static_cast<long double>(magnitude(elem)));
+
+        long double bits = std::log2(2.0L*static_cast<long double>(std::min(a.size(), b.size()))*max_a*max_b + 1.0L);
+        std::size_t k = 0;
+        for (; k<MAX_COMBINED_PRIMES && bits > 0.0L; ++k)
+            bits -= std::log2(static_cast<long double>(PRIMES[k]));
+
+        return (bits > 0.0L) ? 0 : std::max<std::size_t>(k, 1);
+    }
+
+    template <typename T>
+    T to_integer (int128 x){
+        if (x > static_cast<int128>(std::numeric_limits<T>::max()) ||
+                x < static_cast<int128>(std::numeric_limits<T>::min()))
+            throw std::overflow_error("fgs::multimodular: result does not fit the coefficient type");
+
+        return static_cast<T>(x);
+    }
+
+    /* Exact product of two integer coefficient sequences with count primes
+     * (see primes_needed), each one multiplied with its own NTT on its own
+     * thread. Throws std::overflow_error if a coefficient of the result
+     * doesn't fit in T
+     */
+    template <typename T>
+    std::vector<T> multiply (const std::vector<T>& a, const std::vector<T>& b, std::size_t count){
+        const auto residues = map_primes(0, count, [&a, &b](auto prime){
+            using Mod = ModInt<decltype(prime)::value>;
+
+            std::vector<Mod> ma(a.size()), mb(b.size());
+            for (std::size_t i=0; i<a.size(); ++i)
+                ma[i] = Mod(residue(a[i], prime));
+            for (std::size_t i=0; i<b.size(); ++i)
+                mb[i] = Mod(residue(b[i], prime));
+
+            const auto mc = Mod::transform_multiply(ma, mb);
+            std::vector<std::uint32_t> ret(mc.size());
+            for (std::size_t i=0; i<mc.size(); ++i)
+                ret[i] = mc[i].value();
+
+            return ret;
+        });
+
+        std::vector<T> ret(a.size()+b.size()-1);
+        for (std::size_t i=0; i<ret.size(); ++i){
+            crt_accumulator acc;
+            for (std::size_t k=0; k<count; ++k)
+                acc.add(residues[k][i], PRIMES[k]);
+
+            ret[i] = to_integer<T>(acc.symmetric());
+        }
+
+        return ret;
+    }
+}  // namespace fgs::multimodular_aux
+#endif
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "detail.hpp"
+#include "polynomial.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::is_sorted, std::adjacent_find, std::copy
+#include <cstddef>      // std::size_t
+#include <functional>   // std::greater_equal
+#include <stdexcept>    // std::invalid_argument, std::out_of_range
+#include <type_traits>  // std::is_floating_point_v
+#include <utility>      // std::move
+#include <version>      // __cpp_lib_bitops
+
+#ifdef __cpp_lib_bitops
+#include <bit>          // std::countr_one
+#endif
+
+/* Piecewise polynomials (and cubic splines)
+ *
+ * PiecewisePolynomial stores m segments over the breakpoints
+ * b_0 < b_1 < ... < b_m. Segment i is written in the local variable
+ * x - b_i, which keeps its coefficients as well conditioned as the segment
+ * is short, and the coefficients of every segment are stored one after the
+ * other in a single buffer.
+ *
+ * The segment of a point is found by a binary search over the interior
+ * breakpoints stored in Eytzinger (BFS) order: the loop has no data
+ * dependent branches, and the first levels of the tree share cache lines.
+ * Sorted batches of points don't search at all, as a single sweep advances
+ * over the segments and the points at the same time. Points outside of
+ * [b_0, b_m] use the first or the last segment
+ */
+namespace fgs{
+
+namespace piecewise_aux{
+    inline std::size_t trailing_ones (std::size_t k) noexcept{
+#ifdef __cpp_lib_bitops
+        return static_cast<std::size_t>(std::countr_one(k));
+#else
+        std::size_t n = 0;
+        for (; k & 1; k >>= 1)
+            ++n;
+        return n;
+#endif
+    }
+
+    /* Fills tree[1..] with keys in Eytzinger order (the children of node k
+     * are 2k and 2k+1), and rank[k] with the position in keys of tree[k]
+     */
+    template <typename T>
+    void eytzinger (const std::vector<T>& keys, std::vector<T>& tree, std::vector<std::size_t>& rank,
+                    std::size_t& next, std::size_t k){
+        if (k >= tree.size())
+            return;
+
+        eytzinger(keys, tree, rank, next, 2*k);
+        tree[k] = keys[next];
+        rank[k] = next++;
+        eytzinger(keys, tree, rank, next, 2*k+1);
+    }
+
+    /* Solves the tridiagonal system with subdiagonal a, diagonal b and
+     * superdiagonal c (Thomas' algorithm, without pivoting: the systems of
+     * the splines are diagonally dominant). d is overwritten by the solution
+     */
+    template <typename Real, typename T>
+    void solve_tridiagonal (const std::vector<Real>& a, std::vector<Real> b, const std::vector<Real>& c, std::vector<T>& d){
+        const std::size_t n = d.size();
+
+        for (std::size_t i=1; i<n; ++i){
+            const Real w = a[i]/b[i-1];
+            b[i] -= w*c[i-1];
+            d[i] -= d[i-1]*w;
+        }
+
+        d[n-1] /= b[n-1];
+        for (std::size_t i=n-1; i-- > 0;)
+            d[i] = (d[i] - d[i+1]*c[i])/b[i];
+    }
+}
+
+// Variable in which the pieces given to PiecewisePolynomial are written
+enum class PieceVariable{
+    global,     // x
+    local       // x - b_i, being b_i the left breakpoint of the piece
+};
+
+// Class PiecewisePolynomial. CType is the type of the coefficients (real or complex floating-point)
+template <typename CType>
+class PiecewisePolynomial{
+    static_assert(std::is_floating_point_v<detail::reduce_complex_t<CType>>,
+                  "PiecewisePolynomial needs floating-point coefficients");
+
+public:
+    using container_type    = std::vector<CType>;
+    using value_type        = CType;
+    using real_type         = detail::reduce_complex_t<CType>;
+    using size_type         = std::size_t;
+    using polynomial_type   = Polynomial<CType>;
+
+    /* Piece i over [breaks[i], breaks[i+1]), in the variable v. Throws
+     * std::invalid_argument if the breakpoints aren't strictly increasing
+     * or there isn't one piece between every two of them
+     */
+    template <typename CType2>
+    PiecewisePolynomial (std::vector<real_type> breaks, const std::vector<Polynomial<CType2>>& pieces,
+                         PieceVariable v = PieceVariable::global)
+        : breakpoints(std::move(breaks)), offsets{0}
+    {
+        check_breakpoints();
+        if (pieces.size() != segments())
+            throw std::invalid_argument("fgs::PiecewisePolynomial: the number of pieces doesn't match the breakpoints");
+
+        for (size_type i=0; i<pieces.size(); ++i){
+            polynomial_type p(pieces[i]);
+            if (v == PieceVariable::global)
+                p.taylor_shift(value_type(breakpoints[i]));
+
+            coeffs.insert(coeffs.end(), p.begin(), p.end());
+            offsets.push_back(coeffs.size());
+        }
+
+        build_tree();
+    }
+
+    size_type segments () const noexcept{ return breakpoints.size()-1; }
+
+    const std::vector<real_type>& get_breakpoints () const noexcept{ return breakpoints; }
+
+    real_type lower_bound () const noexcept{ return breakpoints.front(); }
+    real_type upper_bound () const noexcept{ return breakpoints.back(); }
+
+    // Degree of segment i
+    size_type degree (size_type i) const{ return offsets.at(i+1) - offsets[i] - 1; }
+
+    // Segment i as a polynomial in x (or in x - b_i if v is PieceVariable::local)
+    polynomial_type segment (size_type i, PieceVariable v = PieceVariable::global) const{
+        if (i >= segments())
+            throw std::out_of_range("fgs::PiecewisePolynomial::segment: segment out of range");
+
+        polynomial_type ret(coeffs.begin() + offsets[i], coeffs.begin() + offsets[i+1]);
+        if (v == PieceVariable::global)
+            ret.taylor_shift(value_type(-breakpoints[i]));
+        return ret;
+    }
+
+    /* Segment of x: the i such that b_i <= x < b_{i+1}, clamped to the
+     * first and last segments (the last one includes b_m)
+     */
+    size_type find (real_type x) const noexcept{
+        const size_type n = tree.size()-1;
+        size_type k = 1;
+
+        // Right if the key is <= x, so the search ends past the first key > x
+        while (k <= n)
+            k = 2*k + static_cast<size_type>(!(x < tree[k]));
+        k >>= piecewise_aux::trailing_ones(k) + 1;
+
+        return k == 0 ? n : rank[k];
+    }
+
+    // Value at x, by Horner's scheme on its segment
+    value_type evaluate_at (real_type x) const{
+        return evaluate_segment(find(x), x);
+    }
+
+    value_type operator() (real_type x) const{
+        return evaluate_at(x);
+    }
+
+    /* Values at every point of x. If x is sorted (ascending), a single
+     * sweep finds every segment; otherwise each point is searched
+     */
+    std::vector<value_type> evaluate_at (const std::vector<real_type>& x) const{
+        std::vector<value_type> ret(x.size());
+
+        if (std::is_sorted(x.begin(), x.end())){
+            size_type i = 0;
+            for (size_type p=0; p<x.size(); ++p){
+                while (i+1 < segments() && !(x[p] < breakpoints[i+1]))
+                    ++i;
+                ret[p] = evaluate_segment(i, x[p]);
+            }
+        }
+        else
+            for (size_type p=0; p<x.size(); ++p)
+                ret[p] = evaluate_at(x[p]);
+
+        return ret;
+    }
+
+    std::vector<value_type> operator() (const std::vector<real_type>& x) const{
+        return evaluate_at(x);
+    }
+
+    // Differentiates every segment (the result is discontinuous where the object wasn't smooth)
+    PiecewisePolynomial& differentiate (){
+        container_type c;
+        std::vector<size_type> o{0};
+        c.reserve(coeffs.size());
+
+        for (size_type i=0; i<segments(); ++i){
+            const size_type first = offsets[i], n = offsets[i+1] - first;
+            for (size_type j=1; j<n; ++j)
+                c.push_back(coeffs[first+j]*real_type(j));
+            if (n == 1)
+                c.push_back(value_type(0));
+            o.push_back(c.size());
+        }
+
+        coeffs = std::move(c);
+        offsets = std::move(o);
+        return *this;
+    }
+
+    /* Replaces the object with its continuous antiderivative F, with
+     * F(b_0) = c: the constant of each segment is the value of the
+     * previous one at their common breakpoint
+     */
+    PiecewisePolynomial& integrate (const value_type& c = value_type(0)){
+        container_type r;
+        std::vector<size_type> o{0};
+        r.reserve(coeffs.size() + segments());
+        value_type constant(c);
+
+        for (size_type i=0; i<segments(); ++i){
+            const size_type first = offsets[i], n = offsets[i+1] - first;
+            r.push_back(constant);
+            for (size_type j=0; j<n; ++j)
+                r.push_back(coeffs[first+j]/real_type(j+1));
+            o.push_back(r.size());
+
+            // F_i at the end of the segment
+            const real_type h = breakpoints[i+1] - breakpoints[i];
+            constant = r.back();
+            for (size_type j=r.size()-1; j>o[i]; --j)
+                constant = r[j-1] + constant*h;
+        }
+
+        coeffs = std::move(r);
+        offsets = std::move(o);
+        return *this;
+    }
+
+    friend bool operator== (const PiecewisePolynomial& lhs, const PiecewisePolynomial& rhs){
+        return lhs.breakpoints == rhs.breakpoints && lhs.offsets == rhs.offsets && lhs.coeffs == rhs.coeffs;
+    }
+    friend bool operator!= (const PiecewisePolynomial& lhs, const PiecewisePolynomial& rhs){
+        return !(lhs == rhs);
+    }
+
+private:
+    std::vector<real_type> breakpoints;     // b_0 < b_1 < ... < b_m
+    std::vector<size_type> offsets;         // Segment i is coeffs[offsets[i], offsets[i+1])
+    container_type coeffs;                  // Coefficients of every segment, lowest degree first
+
+    std::vector<real_type> tree;            // Interior breakpoints in Eytzinger order (from index 1)
+    std::vector<size_type> rank;            // Position of tree[k] among the interior breakpoints
+
+    void check_breakpoints () const{
+        if (breakpoints.size() < 2)
+            throw std::invalid_argument("fgs::PiecewisePolynomial: at least two breakpoints are needed");
+        if (std::adjacent_find(breakpoints.begin(), breakpoints.end(), std::greater_equal<real_type>()) != breakpoints.end())
+            throw std::invalid_argument("fgs::PiecewisePolynomial: breakpoints not strictly increasing");
+    }
+
+    void build_tree (){
+        const std::vector<real_type> keys(breakpoints.begin()+1, breakpoints.end()-1);
+        tree.assign(keys.size()+1, real_type(0));
+        rank.assign(keys.size()+1, 0);
+
+        size_type next = 0;
+        piecewise_aux::eytzinger(keys, tree, rank, next, 1);
+    }
+
+    value_type evaluate_segment (size_type i, real_type x) const{
+        const real_type t = x - breakpoints[i];
+        const value_type* c = coeffs.data() + offsets[i];
+        value_type res = c[offsets[i+1] - offsets[i] - 1];
+
+        for (size_type j=offsets[i+1] - offsets[i] - 1; j>0; --j)
+            res = c[j-1] + res*t;
+
+        return res;
+    }
+};
+
+// Like PiecewisePolynomial::differentiate, but returning an rvalue
+template <typename CType>
+PiecewisePolynomial<CType> differentiate (PiecewisePolynomial<CType> pol){
+    return pol.differentiate();
+}
+
+// Like PiecewisePolynomial::integrate, but returning an rvalue
+template <typename CType>
+PiecewisePolynomial<CType> integrate (PiecewisePolynomial<CType> pol, const CType& c = CType(0)){
+    return pol.integrate(c);
+}
+
+// Integral of pol over [lower_bound, upper_bound]
+template <typename CType>
+CType definite_integral (const PiecewisePolynomial<CType>& pol, typename PiecewisePolynomial<CType>::real_type lower_bound,
+                         typename PiecewisePolynomial<CType>::real_type upper_bound){
+    const auto antiderivative = integrate(pol);
+    return antiderivative(upper_bound) - antiderivative(lower_bound);
+}
+
+namespace piecewise_aux{
+    /* Cubic spline through (x[i], y[i]), from its second derivatives at
+     * the nodes (the solution of a tridiagonal system). With clamped ends
+     * the first derivatives at x[0] and x[n] are d0 and dn; otherwise the
+     * second derivatives there are zero (natural spline)
+     */
+    template <typename Real, typename CType>
+    PiecewisePolynomial<CType> cubic_spline (const std::vector<Real>& x, const std::vector<CType>& y,
+                                             bool clamped, const CType& d0, const CType& dn){
+        if (x.size() != y.size())
+            throw std::invalid_argument("fgs::cubic_spline: different number of abscissas and ordinates");
+        if (x.size() < 2)
+            throw std::invalid_argument("fgs::cubic_spline: at least two nodes are needed");
+
+        const std::size_t n = x.size()-1;
+        std::vector<Real> h(n);
+        std::vector<CType> slope(n);
+        for (std::size_t i=0; i<n; ++i){
+            h[i] = x[i+1] - x[i];
+            slope[i] = (y[i+1] - y[i])/h[i];
+        }
+
+        std::vector<Real> a(n+1, Real(0)), b(n+1, Real(1)), c(n+1, Real(0));
+        std::vector<CType> m(n+1, CType(0));
+        for (std::size_t i=1; i<n; ++i){
+            a[i] = h[i-1];
+            b[i] = Real(2)*(h[i-1] + h[i]);
+            c[i] = h[i];
+            m[i] = (slope[i] - slope[i-1])*Real(6);
+        }
+        if (clamped){
+            b[0] = Real(2)*h[0];
+            c[0] = h[0];
+            m[0] = (slope[0] - d0)*Real(6);
+            a[n] = h[n-1];
+            b[n] = Real(2)*h[n-1];
+            m[n] = (dn - slope[n-1])*Real(6);
+        }
+        solve_tridiagonal(a, b, c, m);
+
+        // s_i(t) = y_i + (slope_i - h_i*(2m_i + m_{i+1})/6)*t + m_i/2*t^2 + (m_{i+1} - m_i)/(6h_i)*t^3
+        std::vector<Polynomial<CType>> pieces;
+        pieces.reserve(n);
+        for (std::size_t i=0; i<n; ++i)
+            pieces.push_back(Polynomial<CType>{y[i], slope[i] - (Real(2)*m[i] + m[i+1])*(h[i]/Real(6)),
+                                               m[i]/Real(2), (m[i+1] - m[i])/(Real(6)*h[i])});
+
+        return PiecewisePolynomial<CType>(x, pieces, PieceVariable::local);
+    }
+}
+
+/* Natural cubic spline through (x[i], y[i]) (x strictly increasing): the
+ * C2 piecewise cubic with zero second derivative at both ends
+ */
+template <typename Real, typename CType>
+PiecewisePolynomial<CType> cubic_spline (const std::vector<Real>& x, const std::vector<CType>& y){
+    return piecewise_aux::cubic_spline(x, y, false, CType(0), CType(0));
+}
+
+/* Clamped cubic spline through (x[i], y[i]): the first derivatives at
+ * both ends are d0 and dn. It reproduces any cubic exactly
+ */
+template <typename Real, typename CType>
+PiecewisePolynomial<CType> cubic_spline (const std::vector<Real>& x, const std::vector<CType>& y,
+                                         const CType& d0, const CType& dn){
+    return piecewise_aux::cubic_spline(x, y, true, d0, dn);
+}
+
+}  // namespace fgs
@@ -1,6 +1,13 @@
 #pragma once
 
 #include "detail.hpp"
+#include "convolution.hpp"
+#include "multimodular.hpp"
+#include "modint.hpp"
+#include "split_complex.hpp"
+#include "tuning.hpp"
+#include "instrumentation.hpp"
+#include "cow_vector.hpp"
 
 #include <vector>
 #include <algorithm>
@@ -10,6 +17,11 @@
 #include <complex>
 #include <numeric>
 #include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <array>
+#include <future>
+#include <thread>
 
 namespace fgs{
 
@@ -20,6 +32,336 @@ using traits_category = typename std::iterator_traits<Iterator>::iterator_catego
 template <typename Iterator>
 using traits_type = typename std::iterator_traits<Iterator>::value_type;
 
+namespace shift_aux{
+    /* The factorial-scaled convolution mixes terms whose magnitudes differ by
+     * many orders (n! against 1/n!), so with floating-point coefficients it
+     * loses every significant digit. Only exact field types use it (integers
+     * can't divide by the factorials)
+     */
+    template <typename T>
+    inline constexpr bool use_convolution_v = !std::is_floating_point_v<detail::reduce_complex_t<T>> &&
+                                              !std::is_integral_v<T>;
+
+    /* Replaces c (lowest degree first) with the coefficients of c(x+a)
+     * by repeated synthetic division, in place and without allocating
+     */
+    template <typename T>
+    FGS_CONSTEXPR void taylor_shift_horner (std::vector<T>& c, const T& a){
+        for (std::size_t i=0; i+1<c.size(); ++i)
+            for (std::size_t j=c.size()-1; j>i; --j)
+                c[j-1] += a*c[j];
+    }
+
+    /* Replaces c (lowest degree first) with the coefficients of c(x+a)
+     * using a single product:
+     *
+     *   k!*b_k = sum_j (c_{k+j}*(k+j)!) * (a^j/j!)
+     *
+     * The characteristic of T must be greater than c.size()-1
+     */
+    template <typename T>
+    void taylor_shift_convolution (std::vector<T>& c, const T& a){
+        const std::size_t n = c.size();
+        std::vector<T> u(n), v(n), fact(n);
+
+        fact[0] = T(1);
+        for (std::size_t i=1; i<n; ++i)
+            fact[i] = fact[i-1]*T(i);
+
+        // u holds c_i*i! in reverse order, so the product lines up as a correlation
+        v[0] = T(1);
+        for (std::size_t i=0; i<n; ++i){
+            u[n-1-i] = c[i]*fact[i];
+            if (i > 0)
+                v[i] = v[i-1]*a/T(i);
+        }
+
+        const auto w = convolution_aux::convolve(u, v);
+        for (std::size_t k=0; k<n; ++k)
+            c[k] = w[n-1-k]/fact[k];
+    }
+
+    template <typename T>
+    FGS_CONSTEXPR void taylor_shift (std::vector<T>& c, const T& a){
+        if (a == T(0))
+            return;
+
+        if constexpr (use_convolution_v<T>)
+            if (!detail::is_constant_evaluated() && c.size() >= tuning::threshold<T>(tuning::Threshold::taylor_shift) &&
+                    detail::factorials_invertible<T>(c.size()))
+                return taylor_shift_convolution(c, a);
+
+        taylor_shift_horner(c, a);
+    }
+
+    // Replaces c (lowest degree first) with the coefficients of c(s*x)
+    template <typename T>
+    FGS_CONSTEXPR void scale (std::vector<T>& c, const T& s){
+        T power(s);
+
+        for (std::size_t i=1; i<c.size(); ++i){
+            c[i] *= power;
+            power *= s;
+        }
+    }
+}
+
+namespace division_aux{
+    /* The power series inverse needs a field, so integers keep the long
+     * division. So do floating-point coefficients: Newton's division goes
+     * through a truncated inverse, whose error is much larger than the one
+     * of the long division
+     */
+    template <typename T>
+    inline constexpr bool use_newton_v = !std::is_floating_point_v<detail::reduce_complex_t<T>> &&
+                                         !std::is_integral_v<T>;
+
+    /* Quotient of a by b (a.size() >= b.size()), from the reversed
+     * coefficients: rev(q) = rev(a)/rev(b) mod x^(deg(a)-deg(b)+1). It only
+     * costs a power series inverse and a truncated product
+     */
+    template <typename T>
+    std::vector<T> quotient (const std::vector<T>& a, const std::vector<T>& b){
+        const std::size_t m = a.size()-b.size()+1;
+        const auto ra = convolution_aux::copy_of<T>(a.rbegin(), std::next(a.rbegin(), m));
+        const auto rb = convolution_aux::copy_of<T>(b.rbegin(), b.rend());
+
+        auto q = convolution_aux::convolve_trunc(ra, convolution_aux::inverse_trunc(rb, m), m);
+        std::reverse(q.begin(), q.end());
+
+        return q;
+    }
+
+    // Remainder of a by b (b not constant), given their quotient q
+    template <typename T>
+    std::vector<T> remainder (const std::vector<T>& a, const std::vector<T>& b, const std::vector<T>& q){
+        auto r = convolution_aux::convolve_trunc(b, q, b.size()-1);
+
+        for (std::size_t i=0; i<r.size(); ++i)
+            r[i] = a[i] - r[i];
+
+        return r;
+    }
+}
+
+/* Kernels on coefficient sequences (lowest degree first), writing into
+ * caller-owned vectors whose capacity is reused: a loop that keeps its
+ * buffers alive (like the Euclidean algorithm) doesn't touch the heap once
+ * they have grown. The results are normalized like the coefficients of a
+ * Polynomial (no leading zeros, and at least one coefficient), and the
+ * operators of Polynomial are built on them.
+ *
+ * The output may be the first operand (it's then updated in place). Only
+ * the products from the FFT threshold on and Newton's division allocate,
+ * as their temporaries are negligible next to the transforms
+ */
+namespace kernels{
+    template <typename T>
+    FGS_CONSTEXPR void normalize (std::vector<T>& c){
+        while (c.size() > 1 && c.back() == T(0))
+            c.pop_back();
+        if (c.empty())
+            c.push_back(T(0));
+    }
+
+    template <typename T, typename U>
+    FGS_CONSTEXPR bool same (const std::vector<T>& a, const std::vector<U>& b){
+        return static_cast<const void*>(&a) == static_cast<const void*>(&b);
+    }
+
+    // out = a + b (out may also be b)
+    template <typename T, typename U, typename V>
+    FGS_CONSTEXPR void add_into (std::vector<T>& out, const std::vector<U>& a, const std::vector<V>& b){
+        const std::size_t na = a.size(), nb = b.size(), n = std::min(na, nb);
+        FGS_INSTRUMENT_ALLOCATION(out, std::max(na, nb));
+        out.resize(std::max(na, nb), T(0));
+
+        for (std::size_t i=0; i<n; ++i)
+            out[i] = T(a[i]) + T(b[i]);
+        for (std::size_t i=n; i<na; ++i)
+            out[i] = T(a[i]);
+        for (std::size_t i=n; i<nb; ++i)
+            out[i] = T(b[i]);
+
+        normalize(out);
+    }
+
+    // out = a - b (out may also be b)
+    template <typename T, typename U, typename V>
+    FGS_CONSTEXPR void sub_into (std::vector<T>& out, const std::vector<U>& a, const std::vector<V>& b){
+        const std::size_t na = a.size(), nb = b.size(), n = std::min(na, nb);
+        FGS_INSTRUMENT_ALLOCATION(out, std::max(na, nb));
+        out.resize(std::max(na, nb), T(0));
+
+        for (std::size_t i=0; i<n; ++i)
+            out[i] = T(a[i]) - T(b[i]);
+        for (std::size_t i=n; i<na; ++i)
+            out[i] = T(a[i]);
+        for (std::size_t i=n; i<nb; ++i)
+            out[i] = T(0) - T(b[i]);
+
+        normalize(out);
+    }
+
+    /* out = a*b. Below the FFT threshold it's the schoolbook product, done
+     * in place from the highest coefficient down. If out is b, b is read
+     * from a copy. Signed integers always go through convolve, which throws
+     * instead of overflowing (in constant evaluation overflow doesn't compile)
+     */
+    template <typename T, typename U, typename V>
+    FGS_CONSTEXPR void multiply_into (std::vector<T>& out, const std::vector<U>& a, const std::vector<V>& b){
+        const std::size_t na = a.size(), nb = b.size();
+
+        if (!detail::is_constant_evaluated() && (multimodular_aux::is_supported_v<T> ||
+                std::min(na, nb) >= tuning::threshold<T>(tuning::Threshold::fft))){
+            if constexpr (std::is_same_v<T, U> && std::is_same_v<T, V>)
+                out = convolution_aux::convolve(a, b);
+            else
+                out = convolution_aux::convolve(convolution_aux::copy_of<T>(a.begin(), a.end()),
+                                                convolution_aux::copy_of<T>(b.begin(), b.end()));
+            normalize(out);
+            return;
+        }
+
+        if (same(out, b)){
+            const auto copy = convolution_aux::copy_of<V>(b.begin(), b.end());
+            multiply_into(out, a, copy);
+            return;
+        }
+
+        FGS_INSTRUMENT_ALLOCATION(out, na+nb-1);
+        FGS_INSTRUMENT_FLOPS(na*nb);
+        if (!same(out, a))
+            out.assign(a.begin(), a.end());
+        out.resize(na+nb-1, T(0));
+
+        for (std::size_t i=na; i-- > 0;){
+            for (std::size_t j=nb-1; j>0; --j)
+                out[i+j] += out[i]*T(b[j]);
+            out[i] = out[i]*T(b[0]);
+        }
+
+        normalize(out);
+    }
+
+    /* Long division of r by b in place: r ends up holding the remainder,
+     * and q (if not null, with r.size()-b.size()+1 coefficients) the
+     * quotient. The high part of r is dropped, since it's zero by
+     * construction even if rounding leaves residues there (which would
+     * keep Euclid's algorithm from ending)
+     */
+    template <typename T, typename U>
+    FGS_CONSTEXPR void long_division (std::vector<T>& r, const std::vector<U>& b, std::vector<T>* q){
+        const std::size_t nb = b.size();
+        FGS_INSTRUMENT_FLOPS((r.size()-nb+1)*nb);
+
+        for (std::size_t i=r.size()-nb+1; i-- > 0;){
+            const T coc = r[nb+i-1]/T(b.back());
+            if (q)
+                (*q)[i] = coc;
+            for (std::size_t j=nb-1; j-- > 0;)
+                r[i+j] -= T(b[j])*coc;
+        }
+
+        if (nb == 1)
+            r.assign(1, T(0));
+        else
+            r.resize(nb-1);
+        normalize(r);
+    }
+
+    template <typename T, typename U>
+    FGS_CONSTEXPR bool use_newton (const std::vector<T>& a, const std::vector<U>& b){
+        return division_aux::use_newton_v<T> && !detail::is_constant_evaluated() &&
+               std::min(a.size()-b.size()+1, b.size()) >= tuning::threshold<T>(tuning::Threshold::newton);
+    }
+
+    /* q = a/b and r = a%b with a single division. r may be a, but q must
+     * not be any of the others
+     */
+    template <typename T, typename U>
+    FGS_CONSTEXPR void divmod (const std::vector<T>& a, const std::vector<U>& b, std::vector<T>& q, std::vector<T>& r){
+        if (a.size() < b.size()){
+            q.assign(1, T(0));
+            if (!same(r, a)){
+                FGS_INSTRUMENT_ALLOCATION(r, a.size());
+                r.assign(a.begin(), a.end());
+            }
+            return;
+        }
+
+        if (use_newton(a, b)){
+            const auto divisor = convolution_aux::copy_of<T>(b.begin(), b.end());
+            q = division_aux::quotient(a, divisor);
+            r = division_aux::remainder(a, divisor, q);
+            normalize(r);
+            return;
+        }
+
+        FGS_INSTRUMENT_ALLOCATION(q, a.size()-b.size()+1);
+        q.resize(a.size()-b.size()+1);
+        if (!same(r, a)){
+            FGS_INSTRUMENT_ALLOCATION(r, a.size());
+            r.assign(a.begin(), a.end());
+        }
+        long_division(r, b, &q);
+    }
+
+    // out = a/b
+    template <typename T, typename U>
+    FGS_CONSTEXPR void div_into (std::vector<T>& out, const std::vector<T>& a, const std::vector<U>& b){
+        // Newton's division doesn't need the remainder
+        if (a.size() >= b.size() && use_newton(a, b)){
+            out = division_aux::quotient(a, convolution_aux::copy_of<T>(b.begin(), b.end()));
+            return;
+        }
+
+        std::vector<T> other;
+        if (same(out, a)){
+            divmod(a, b, other, out);
+            out = std::move(other);
+        }
+        else
+            divmod(a, b, out, other);
+    }
+
+    // out = a%b
+    template <typename T, typename U>
+    FGS_CONSTEXPR void mod_into (std::vector<T>& out, const std::vector<T>& a, const std::vector<U>& b){
+        if (a.size() >= b.size() && use_newton(a, b)){
+            const auto divisor = convolution_aux::copy_of<T>(b.begin(), b.end());
+            out = division_aux::remainder(a, divisor, division_aux::quotient(a, divisor));
+            normalize(out);
+            return;
+        }
+
+        if (!same(out, a)){
+            FGS_INSTRUMENT_ALLOCATION(out, a.size());
+            out.assign(a.begin(), a.end());
+        }
+        if (a.size() >= b.size())
+            long_division(out, b, static_cast<std::vector<T>*>(nullptr));
+    }
+
+    // out = a' (the derivative)
+    template <typename T, typename U>
+    FGS_CONSTEXPR void differentiate_into (std::vector<T>& out, const std::vector<U>& a){
+        const std::size_t n = a.size();
+        if (n == 1){
+            out.assign(1, T(0));
+            return;
+        }
+
+        if (!same(out, a))
+            out.resize(n-1);
+        for (std::size_t i=1; i<n; ++i)
+            out[i-1] = T(a[i])*T(i);
+
+        out.resize(n-1);
+        normalize(out);
+    }
+}
+
 // Class Polynomial. CType is the type of the coefficients.
 //
 // CType should behave as a field (float, double, long double and the
@@ -32,6 +374,18 @@ public:
     template <typename CType2>
     friend class Polynomial;
 
+    // The kernels that write into a polynomial reach its coefficients
+    template <typename T, typename U, typename V>
+    friend FGS_CONSTEXPR void add_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b);
+    template <typename T, typename U, typename V>
+    friend FGS_CONSTEXPR void sub_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b);
+    template <typename T, typename U, typename V>
+    friend FGS_CONSTEXPR void multiply_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b);
+    template <typename T, typename U>
+    friend FGS_CONSTEXPR void divmod (const Polynomial<T>& a, const Polynomial<U>& b, Polynomial<T>& q, Polynomial<T>& r);
+    template <typename T, typename U>
+    friend FGS_CONSTEXPR void differentiate_into (Polynomial<T>& out, const Polynomial<U>& a);
+
     // typedefs for the member types (just get the ones from the
     // underlined container).
     using container_type            = std::vector<CType>;
@@ -49,60 +403,71 @@ public:
     using const_reverse_iterator    = typename container_type::const_reverse_iterator;
 
     // Default constructors, operator='s and destructor
+#ifdef INSTRUMENTATION_SUPPORT
+    // Copies made by the operators are counted, unless they share the buffer (COPY_ON_WRITE_SUPPORT)
+    Polynomial (const Polynomial& other)
+        : storage(other.storage), var(other.var)
+    {
+        if (&read() != &other.read())
+            FGS_INSTRUMENT_ALLOCATION(container_type(), read().size());
+    }
+#else
     Polynomial (const Polynomial&)                                       = default;
+#endif
     Polynomial (Polynomial&&)
-        noexcept(noexcept(container_type(container_type())))             = default;
+        noexcept(noexcept(storage_type(std::declval<storage_type>())))   = default;
     Polynomial& operator= (const Polynomial&)                            = default;
     Polynomial& operator= (Polynomial&&)
-        noexcept(noexcept(container_type().operator=(container_type()))) = default;
+        noexcept(std::is_nothrow_move_assignable_v<storage_type>)        = default;
     ~Polynomial ()                                                       = default;
 
 
     // Some constructors
-    explicit Polynomial ()
-        : coeffs(1, value_type(0)) {}
+    FGS_CONSTEXPR explicit Polynomial ()
+        : storage(container_type(1, value_type(0))) {}
     template <typename U>
-    explicit Polynomial (const U& x)
-        : coeffs(1, value_type(x)) {}
-    Polynomial (std::initializer_list<value_type> l)
-        : coeffs(l) { adjust_degree(); }
+    FGS_CONSTEXPR explicit Polynomial (const U& x)
+        : storage(container_type(1, value_type(x))) {}
+    FGS_CONSTEXPR Polynomial (std::initializer_list<value_type> l)
+        : storage(container_type(l)) { adjust_degree(); }
 
     // Range constructor using tag dispatching for input iterators
     template <typename InputIt>
-    Polynomial (InputIt first, InputIt last)
-        : coeffs(first, last) { adjust_degree(); }
+    FGS_CONSTEXPR Polynomial (InputIt first, InputIt last)
+        : storage(container_type(first, last)) { adjust_degree(); }
 
     // Constructor using the elements of a container (in the future
     // also ranges will be accepted)
     template <template<typename...> typename Cont, typename ...Args,
                 typename = std::enable_if_t<detail::is_iterable_v<Cont<Args...>>>>
-    explicit Polynomial (const Cont<Args...>& cont)
+    FGS_CONSTEXPR explicit Polynomial (const Cont<Args...>& cont)
         : Polynomial(std::begin(cont), std::end(cont)) {}
 
-    reference       operator[] (size_type i)       { return coeffs[i]; }
-    const_reference operator[] (size_type i) const { return coeffs[i]; }
+    FGS_CONSTEXPR reference       operator[] (size_type i)       { return expose()[i]; }
+    FGS_CONSTEXPR const_reference operator[] (size_type i) const { return read()[i]; }
 
-    reference       at (size_type i)       { return coeffs.at(i); }
-    const_reference at (size_type i) const { return coeffs.at(i); }
+    FGS_CONSTEXPR reference       at (size_type i)       { return expose().at(i); }
+    FGS_CONSTEXPR const_reference at (size_type i) const { return read().at(i); }
 
-    reference       first()       { return coeffs.front(); }
-    const_reference first() const { return coeffs.front(); }
+    FGS_CONSTEXPR reference       first()       { return expose().front(); }
+    FGS_CONSTEXPR const_reference first() const { return read().front(); }
 
-    reference       last()       { return coeffs.back(); }
-    const_reference last() const { return coeffs.back(); }
+    FGS_CONSTEXPR reference       last()       { return expose().back(); }
+    FGS_CONSTEXPR const_reference last() const { return read().back(); }
 
-    void set_coefficient (size_type i, const value_type& elem){
-        if (i >= coeffs.size())
-            coeffs.resize(i+1, value_type(0));
+    FGS_CONSTEXPR void set_coefficient (size_type i, const value_type& elem){
+        auto &c = write();
+        if (i >= c.size())
+            c.resize(i+1, value_type(0));
 
-        coeffs[i] = elem;
+        c[i] = elem;
         adjust_degree();
     }
 
-    char get_variable () const noexcept{ return var; }
-    void set_variable (char c) noexcept{ var = c; }
+    FGS_CONSTEXPR char get_variable () const noexcept{ return var; }
+    FGS_CONSTEXPR void set_variable (char c) noexcept{ var = c; }
 
-    size_type degree () const noexcept{ return coeffs.size()-1; }
+    FGS_CONSTEXPR size_type degree () const noexcept{ return read().size()-1; }
 
     /* Evaluates the polynomial for the value x using the Horner's
      * polynomial evaluation scheme.
@@ -110,7 +475,11 @@ public:
      * RType is the type of the evaluation
      */
     template<typename RType>
-    auto evaluate_at (const RType& x) const{
+    FGS_CONSTEXPR auto evaluate_at (const RType& x) const{
+        FGS_INSTRUMENT_SCOPE(evaluation);
+        const auto &coeffs = read();
+        FGS_INSTRUMENT_FLOPS(coeffs.size()-1);
+
         using CommonType = std::common_type_t<value_type, RType>;
         CommonType res(coeffs.back());
 
@@ -120,15 +489,91 @@ public:
         return res;
     }
 
-    template <typename CType2>
-    auto evaluate_at (const Polynomial<CType2> &pol) const{
-        using CommonType = std::common_type_t<value_type, CType2>;
-        Polynomial<CommonType> res(coeffs.back());
+    /* Writes p(x), p'(x),..., p^(k)(x) to out[0],..., out[k], in a single
+     * Horner's pass that carries the k derivatives along (the coefficients
+     * are read once, and nothing is allocated). out must be a random
+     * access iterator, as the values are accumulated in place
+     */
+    template <typename RType, typename RandomIt>
+    FGS_CONSTEXPR void evaluate_with_derivatives (const RType& x, size_type k, RandomIt out) const{
+        FGS_INSTRUMENT_SCOPE(evaluation);
+        const auto &coeffs = read();
+        FGS_INSTRUMENT_FLOPS((coeffs.size()-1)*(k+1));
 
-        for (size_type i=coeffs.size()-1; i>0; --i)
-            res = CommonType(coeffs[i-1]) + res*Polynomial<CommonType>(pol);
+        using CommonType = std::common_type_t<value_type, RType>;
+        const CommonType y(x);
 
-        return res;
+        out[0] = CommonType(coeffs.back());
+        for (size_type j=1; j<=k; ++j)
+            out[j] = CommonType(0);
+
+        for (size_type i=coeffs.size()-1; i>0; --i){
+            // Only the first degree()-i+1 derivatives can be nonzero yet
+            for (size_type j=std::min(k, coeffs.size()-i); j>0; --j)
+                out[j] = out[j]*y + out[j-1];
+            out[0] = out[0]*y + CommonType(coeffs[i-1]);
+        }
+
+        // out[j] holds p^(j)(x)/j!
+        CommonType factorial(1);
+        for (size_type j=2; j<=k; ++j){
+            factorial *= CommonType(j);
+            out[j] *= factorial;
+        }
+    }
+
+    // p(x) and its first k derivatives, as above
+    template <typename RType>
+    FGS_CONSTEXPR auto evaluate_with_derivatives (const RType& x, size_type k) const{
+        std::vector<std::common_type_t<value_type, RType>> ret(k+1);
+        evaluate_with_derivatives(x, k, ret.begin());
+        return ret;
+    }
+
+    /* The same at every point of x: row j of the result holds the j-th
+     * derivative at every point. The points are the innermost loop, so
+     * it vectorizes over them
+     */
+    template <typename RType>
+    FGS_CONSTEXPR auto evaluate_with_derivatives (const std::vector<RType>& x, size_type k) const{
+        FGS_INSTRUMENT_SCOPE(evaluation);
+        const auto &coeffs = read();
+        FGS_INSTRUMENT_FLOPS((coeffs.size()-1)*(k+1)*x.size());
+
+        using CommonType = std::common_type_t<value_type, RType>;
+        std::vector<std::vector<CommonType>> ret(k+1, std::vector<CommonType>(x.size(), CommonType(0)));
+        std::fill(ret[0].begin(), ret[0].end(), CommonType(coeffs.back()));
+
+        for (size_type i=coeffs.size()-1; i>0; --i){
+            for (size_type j=std::min(k, coeffs.size()-i); j>0; --j){
+                auto &row = ret[j];
+                const auto &prev = ret[j-1];
+                for (size_type p=0; p<x.size(); ++p)
+                    row[p] = row[p]*CommonType(x[p]) + prev[p];
+            }
+
+            const CommonType c(coeffs[i-1]);
+            for (size_type p=0; p<x.size(); ++p)
+                ret[0][p] = ret[0][p]*CommonType(x[p]) + c;
+        }
+
+        CommonType factorial(1);
+        for (size_type j=2; j<=k; ++j){
+            factorial *= CommonType(j);
+            for (auto &elem : ret[j])
+                elem *= factorial;
+        }
+
+        return ret;
+    }
+
+    /* Composes the polynomial with pol (the result is p(pol(x))). See
+     * fgs::compose for the algorithm used
+     */
+    template <typename CType2>
+    FGS_CONSTEXPR auto evaluate_at (const Polynomial<CType2> &pol) const{
+        using CommonType = std::common_type_t<value_type, CType2>;
+        return compose(Polynomial<CommonType>(*this), Polynomial<CommonType>(pol));
     }
 
     /* Enable natural evaluation of a mathematical function, so you
@@ -136,129 +581,97 @@ public:
      * of the evaluation
      */
     template<typename RType>
-    auto operator() (const RType& x) const{
+    FGS_CONSTEXPR auto operator() (const RType& x) const{
         return evaluate_at(x);
     }
 
     // Unary + and - operators
-    Polynomial operator+() const { return Polynomial(*this); }
-    Polynomial operator-() const { return Polynomial(*this) *= value_type(-1); }
+    FGS_CONSTEXPR Polynomial operator+() const { return Polynomial(*this); }
+    FGS_CONSTEXPR Polynomial operator-() const { return Polynomial(*this) *= value_type(-1); }
 
     // This is just a cool way to
-    Polynomial operator^ (unsigned n){
+    FGS_CONSTEXPR Polynomial operator^ (unsigned n){
         return Polynomial(*this).pow(n);
     }
 
-    // Operator overloadings for polynomials arithmetic
+    // Operator overloadings for polynomials arithmetic (see kernels)
     template <typename T>
-    Polynomial& operator+= (const Polynomial<T>& pol){
-        coeffs.resize(std::max(coeffs.size(), pol.coeffs.size()), value_type(0));
-
-        for (size_type i=0; i<pol.coeffs.size(); ++i)
-            coeffs[i] += value_type(pol.coeffs[i]);
-
-        adjust_degree();
+    FGS_CONSTEXPR Polynomial& operator+= (const Polynomial<T>& pol){
+        FGS_INSTRUMENT_SCOPE(addition);
+        auto &c = write();
+        kernels::add_into(c, c, pol.read());
         return *this;
     }
 
     template <typename T>
-    Polynomial& operator-= (const Polynomial<T>& pol){
-        coeffs.resize(std::max(coeffs.size(), pol.coeffs.size()), value_type(0));
-
-        for (size_type i=0; i<pol.coeffs.size(); ++i)
-            coeffs[i] -= value_type(pol.coeffs[i]);
-
-        adjust_degree();
+    FGS_CONSTEXPR Polynomial& operator-= (const Polynomial<T>& pol){
+        FGS_INSTRUMENT_SCOPE(substraction);
+        auto &c = write();
+        kernels::sub_into(c, c, pol.read());
         return *this;
     }
 
     template <typename T>
-    Polynomial& operator*= (const Polynomial<T>& pol){
-        coeffs.resize(coeffs.size()+pol.coeffs.size()-1, value_type(0));
-
-        for (int i=coeffs.size()-pol.coeffs.size(); i>=0; --i){
-            for (size_type j=pol.coeffs.size()-1; j>0; --j)
-                coeffs[i+j] += coeffs[i]*value_type(pol.coeffs[j]);
-            coeffs[i] = coeffs[i]*value_type(pol.coeffs[0]);
-        }
-
+    FGS_CONSTEXPR Polynomial& operator*= (const Polynomial<T>& pol){
+        FGS_INSTRUMENT_SCOPE(multiplication);
+        auto &c = write();
+        kernels::multiply_into(c, c, pol.read());
         return *this;
     }
 
     template <typename T>
-    Polynomial& operator/= (const Polynomial<T>& pol){
-        if (coeffs.size() < pol.coeffs.size()){
-            coeffs.resize(1);
-            coeffs[0] = value_type(0);
-            return *this;
-        }
+    FGS_CONSTEXPR Polynomial& operator/= (const Polynomial<T>& pol){
+        FGS_INSTRUMENT_SCOPE(division);
 
-        container_type coc(coeffs.size()-pol.coeffs.size()+1, value_type(0));
-
-        for (int i=coc.size()-1; i>=0; --i){
-            coc[i] = coeffs[pol.coeffs.size()+i-1]/value_type(pol.coeffs.back());
-            for (int j=pol.coeffs.size()-2; j>=0; --j)
-                coeffs[i+j] -= value_type(pol.coeffs[j])*coc[i];
-        }
-
-        coeffs = std::move(coc);
+        auto &c = write();
+        kernels::div_into(c, c, pol.read());
         return *this;
     }
 
     template <typename T>
-    Polynomial& operator%= (const Polynomial<T>& pol){
-        if (coeffs.size() < pol.coeffs.size())
-            return *this;
-
-        value_type coc;
-
-        for (int i=coeffs.size()-pol.coeffs.size(); i>=0; --i){
-            coc = coeffs[pol.coeffs.size()+i-1]/value_type(pol.coeffs.back());
-            for (int j=pol.coeffs.size()-1; j>=0; --j)
-                coeffs[i+j] -= value_type(pol.coeffs[j])*coc;
-        }
-
-        adjust_degree();
+    FGS_CONSTEXPR Polynomial& operator%= (const Polynomial<T>& pol){
+        FGS_INSTRUMENT_SCOPE(modulus);
+        auto &c = write();
+        kernels::mod_into(c, c, pol.read());
         return *this;
     }
 
     template <typename U>
-    Polynomial& operator+=(const U& other){
-        coeffs[0] += value_type(other);
+    FGS_CONSTEXPR Polynomial& operator+=(const U& other){
+        write()[0] += value_type(other);
         return *this;
     }
     template <typename U>
-    Polynomial& operator-=(const U& other){
-        coeffs[0] -= value_type(other);
+    FGS_CONSTEXPR Polynomial& operator-=(const U& other){
+        write()[0] -= value_type(other);
         return *this;
     }
     template <typename U>
-    Polynomial& operator*=(const U& other){
-        for (auto &coeff : coeffs)
+    FGS_CONSTEXPR Polynomial& operator*=(const U& other){
+        for (auto &coeff : write())
             coeff *= value_type(other);
 
         return *this;
     }
     template <typename U>
-    Polynomial& operator/=(const U& other){
-        for (auto &coeff : coeffs)
+    FGS_CONSTEXPR Polynomial& operator/=(const U& other){
+        for (auto &coeff : write())
             coeff /= value_type(other);
 
         return *this;
     }
     template <typename U>
-    Polynomial& operator%=(const U&){   // NOLINT(readability-named-parameter)
-        coeffs.resize(1, 0);
+    FGS_CONSTEXPR Polynomial& operator%=(const U&){   // NOLINT(readability-named-parameter)
+        write().resize(1, 0);
         return *this;
     }
 
     /* Modifies the coefficients so they match the polynomial to the
      * power of n (n must be unsigned type)
      */
-    Polynomial& pow(unsigned n) {
+    FGS_CONSTEXPR Polynomial& pow(unsigned n) {
         if (n==0){
-            coeffs.resize(1);
-            coeffs.front() = value_type(1);
+            write().assign(1, value_type(1));
             return *this;
         }
 
@@ -270,25 +683,80 @@ public:
         return *this;
     }
 
+    /* Modifies the coefficients so they match the polynomial p(x+a),
+     * where p is the polynomial defined by *this (Taylor shift)
+     */
+    template <typename U>
+    FGS_CONSTEXPR Polynomial& taylor_shift (const U& a){
+        shift_aux::taylor_shift(write(), value_type(a));
+        return *this;
+    }
+
+    /* Modifies the coefficients so they match the polynomial p(s*x),
+     * where p is the polynomial defined by *this
+     */
+    template <typename U>
+    FGS_CONSTEXPR Polynomial& scale (const U& s){
+        shift_aux::scale(write(), value_type(s));
+        adjust_degree();
+        return *this;
+    }
+
     /* Modifies the coefficients so they match the derivative of
      * the polynomial defined by *this
      */
-    Polynomial& differentiate (){
-        if (coeffs.size() == 1)
-            coeffs[0] = value_type(0);
-        else{
-            for (size_type i=1; i<coeffs.size(); ++i)
-                coeffs[i-1] = coeffs[i]*value_type(i);
-            coeffs.resize(coeffs.size()-1);
+    FGS_CONSTEXPR Polynomial& differentiate (){
+        auto &c = write();
+        kernels::differentiate_into(c, c);
+        return *this;
+    }
+
+    /* Writes the k-th derivative of the polynomial into out, reusing its
+     * storage (out may be *this). It takes a single pass: coefficient i
+     * is multiplied by the falling factorial i*(i-1)*...*(i-k+1), built
+     * incrementally from the one of i-1
+     */
+    FGS_CONSTEXPR void derivative (size_type k, Polynomial& out) const{
+        out.var = var;
+        if (k > degree()){
+            out.write().assign(1, value_type(0));
+            return;
         }
 
-        return *this;
+        // First out, so if it's *this, c is the buffer being written
+        auto &o = out.write();
+        const auto &c = read();
+        FGS_INSTRUMENT_ALLOCATION(o, c.size()-k);
+        if (&out != this)
+            o.resize(c.size()-k);
+
+        // k! for i = k, and then i!/(i-k)! = (i-1)!/(i-1-k)! * i/(i-k), an exact division
+        value_type factor(1);
+        for (size_type i=2; i<=k; ++i)
+            factor *= value_type(i);
+
+        // Unless i-k can be 0 in the field (ModInt<P> from i-k = P on): then each factor takes k products
+        const bool divide = detail::factorials_invertible<value_type>(c.size());
+        for (size_type i=k; i<c.size(); ++i){
+            if (i > k && divide)
+                factor = factor*value_type(i)/value_type(i-k);
+            else if (i > k){
+                factor = value_type(1);
+                for (size_type j=i-k+1; j<=i; ++j)
+                    factor *= value_type(j);
+            }
+            o[i-k] = c[i]*factor;
+        }
+
+        o.resize(c.size()-k);
+        out.adjust_degree();
     }
 
     /* Modifies the coefficients so they match the antiderivative, with
      * integration constant equals to c (0 by default)
      */
-    Polynomial& integrate_const (const value_type& c = value_type(0)){
+    FGS_CONSTEXPR Polynomial& integrate_const (const value_type& c = value_type(0)){
+        auto &coeffs = write();
         if (coeffs.size()==1 && coeffs[0]==value_type(0)){
             coeffs[0] = c;
             return *this;
@@ -308,23 +776,24 @@ public:
      * RType is the type of the evaluation
      */
     template<typename DType, typename RType>
-    Polynomial& integrate_point (const DType& x, const RType& y){
+    FGS_CONSTEXPR Polynomial& integrate_point (const DType& x, const RType& y){
         using CommonType = std::common_type_t<CType, DType, RType>;
-        coeffs[0] = value_type(CommonType(y) - CommonType((*this).integrate_const().evaluate_at(x)));
+        const auto c = value_type(CommonType(y) - CommonType((*this).integrate_const().evaluate_at(x)));
+        write()[0] = c;
         return *this;
     }
 
     // Swap two polynomials
-    friend void swap (Polynomial& lhs, Polynomial& rhs){
+    friend FGS_CONSTEXPR void swap (Polynomial& lhs, Polynomial& rhs){
         using std::swap;
 
-        swap(lhs.coeffs, rhs.coeffs);
+        swap(lhs.storage, rhs.storage);
         swap(lhs.var, rhs.var);
     }
 
     // Conversion from a Polynomial to other of different value_type
     template <typename CType2>
-    explicit operator Polynomial<CType2> () const{
+    FGS_CONSTEXPR explicit operator Polynomial<CType2> () const{
         return Polynomial<CType2>(this->begin(), this->end());
     }
 
@@ -333,100 +802,191 @@ public:
      * It's based on the vector's iterator, so this is just a wrapper
      * for polynomials
      */
-    iterator        begin()       { return coeffs.begin(); }
-    const_iterator  begin() const { return coeffs.begin(); }
+    FGS_CONSTEXPR iterator        begin()       { return expose().begin(); }
+    FGS_CONSTEXPR const_iterator  begin() const { return read().begin(); }
 
-    iterator        end()       { return coeffs.end(); }
-    const_iterator  end() const { return coeffs.end(); }
+    FGS_CONSTEXPR iterator        end()       { return expose().end(); }
+    FGS_CONSTEXPR const_iterator  end() const { return read().end(); }
 
-    reverse_iterator        rbegin()       { return coeffs.rbegin(); }
-    const_reverse_iterator  rbegin() const { return coeffs.rbegin(); }
+    FGS_CONSTEXPR reverse_iterator        rbegin()       { return expose().rbegin(); }
+    FGS_CONSTEXPR const_reverse_iterator  rbegin() const { return read().rbegin(); }
 
-    reverse_iterator        rend()       { return coeffs.rend(); }
-    const_reverse_iterator  rend() const { return coeffs.rend(); }
+    FGS_CONSTEXPR reverse_iterator        rend()       { return expose().rend(); }
+    FGS_CONSTEXPR const_reverse_iterator  rend() const { return read().rend(); }
 
-    const_iterator cbegin() const { return coeffs.cbegin(); }
-    const_iterator cend()   const { return coeffs.cend();   }
+    FGS_CONSTEXPR const_iterator cbegin() const { return read().cbegin(); }
+    FGS_CONSTEXPR const_iterator cend()   const { return read().cend();   }
 
-    const_reverse_iterator crbegin() const { return coeffs.crbegin(); }
-    const_reverse_iterator crend()   const { return coeffs.crend();   }
+    FGS_CONSTEXPR const_reverse_iterator crbegin() const { return read().crbegin(); }
+    FGS_CONSTEXPR const_reverse_iterator crend()   const { return read().crend();   }
 
 private:
-    container_type coeffs;  // Actual coefficients of the polynomial
+#ifdef COPY_ON_WRITE_SUPPORT
+    using storage_type = detail::cow_vector<CType>;
+#else
+    using storage_type = container_type;
+#endif
+
+    storage_type storage;   // Actual coefficients of the polynomial
     char var = 'x';         // Letter that identifies the variable
 
+    // The coefficients, to read
+    FGS_CONSTEXPR const container_type& read () const noexcept{
+#ifdef COPY_ON_WRITE_SUPPORT
+        return storage.read();
+#else
+        return storage;
+#endif
+    }
+
+    // The coefficients, to modify them (getting a buffer of its own if it's shared)
+    FGS_CONSTEXPR container_type& write (){
+#ifdef COPY_ON_WRITE_SUPPORT
+        if (storage.use_count() != 1)
+            FGS_INSTRUMENT_ALLOCATION(container_type(), storage.read().size());
+        return storage.write();
+#else
+        return storage;
+#endif
+    }
+
+    // Like write, when a reference or an iterator to them escapes (see cow_vector.hpp)
+    FGS_CONSTEXPR container_type& expose (){
+#ifdef COPY_ON_WRITE_SUPPORT
+        return storage.expose();
+#else
+        return storage;
+#endif
+    }
+
     // Helper function to adjust the degree, so the last coefficient is not 0
-    void adjust_degree (){
-        while (coeffs.back() == value_type(0) && coeffs.size() > 1)
-            coeffs.pop_back();
+    FGS_CONSTEXPR void adjust_degree (){
+        auto &c = write();
+        while (c.back() == value_type(0) && c.size() > 1)
+            c.pop_back();
     }
 };
 
 template <typename CType1, typename CType2>
-auto operator+(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR auto operator+(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return Polynomial<std::common_type_t<CType1, CType2>>(lhs) += rhs;
 }
 template <typename CType1, typename CType2>
-auto operator-(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR auto operator-(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return Polynomial<std::common_type_t<CType1, CType2>>(lhs) -= rhs;
 }
 template <typename CType1, typename CType2>
-auto operator*(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR auto operator*(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return Polynomial<std::common_type_t<CType1, CType2>>(lhs) *= rhs;
 }
 template <typename CType1, typename CType2>
-auto operator/(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR auto operator/(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return Polynomial<std::common_type_t<CType1, CType2>>(lhs) /= rhs;
 }
 template <typename CType1, typename CType2>
-auto operator%(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR auto operator%(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return Polynomial<std::common_type_t<CType1, CType2>>(lhs) %= rhs;
 }
 
 template <typename CType, typename U>
-auto operator+(const Polynomial<CType>& lhs, const U& rhs){
+FGS_CONSTEXPR auto operator+(const Polynomial<CType>& lhs, const U& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) += rhs;
 }
 template <typename CType, typename U>
-auto operator-(const Polynomial<CType>& lhs, const U& rhs){
+FGS_CONSTEXPR auto operator-(const Polynomial<CType>& lhs, const U& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) -= rhs;
 }
 template <typename CType, typename U>
-auto operator*(const Polynomial<CType>& lhs, const U& rhs){
+FGS_CONSTEXPR auto operator*(const Polynomial<CType>& lhs, const U& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) *= rhs;
 }
 template <typename CType, typename U>
-auto operator/(const Polynomial<CType>& lhs, const U& rhs){
+FGS_CONSTEXPR auto operator/(const Polynomial<CType>& lhs, const U& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) /= rhs;
 }
 template <typename CType, typename U>
-auto operator%(const Polynomial<CType>& lhs, const U& rhs){
+FGS_CONSTEXPR auto operator%(const Polynomial<CType>& lhs, const U& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) %= rhs;
 }
 
 template <typename CType, typename U>
-auto operator+(const U& lhs, const Polynomial<CType>& rhs){
+FGS_CONSTEXPR auto operator+(const U& lhs, const Polynomial<CType>& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) += rhs;
 }
 template <typename CType, typename U>
-auto operator-(const U& lhs, const Polynomial<CType>& rhs){
+FGS_CONSTEXPR auto operator-(const U& lhs, const Polynomial<CType>& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) -= rhs;
 }
 template <typename CType, typename U>
-auto operator*(const U& lhs, const Polynomial<CType>& rhs){
+FGS_CONSTEXPR auto operator*(const U& lhs, const Polynomial<CType>& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) *= rhs;
 }
 template <typename CType, typename U>
-auto operator/(const U& lhs, const Polynomial<CType>& rhs){
+FGS_CONSTEXPR auto operator/(const U& lhs, const Polynomial<CType>& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) /= rhs;
 }
 template <typename CType, typename U>
-auto operator%(const U& lhs, const Polynomial<CType>& rhs){
+FGS_CONSTEXPR auto operator%(const U& lhs, const Polynomial<CType>& rhs){
     return Polynomial<std::common_type_t<CType, U>>(lhs) %= rhs;
 }
 
+/* The kernels (see kernels) on polynomials: the result is written into a
+ * polynomial the caller owns, whose storage is reused, and takes the
+ * variable of a. out may be a itself
+ */
+template <typename T, typename U, typename V>
+FGS_CONSTEXPR void add_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b){
+    FGS_INSTRUMENT_SCOPE(addition);
+    out.var = a.var;
+    auto &o = out.write();
+    kernels::add_into(o, a.read(), b.read());
+}
+
+template <typename T, typename U, typename V>
+FGS_CONSTEXPR void sub_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b){
+    FGS_INSTRUMENT_SCOPE(substraction);
+    out.var = a.var;
+    auto &o = out.write();
+    kernels::sub_into(o, a.read(), b.read());
+}
+
+template <typename T, typename U, typename V>
+FGS_CONSTEXPR void multiply_into (Polynomial<T>& out, const Polynomial<U>& a, const Polynomial<V>& b){
+    FGS_INSTRUMENT_SCOPE(multiplication);
+    out.var = a.var;
+    auto &o = out.write();
+    kernels::multiply_into(o, a.read(), b.read());
+}
+
+/* Quotient and remainder of a by b with a single division. r may be a,
+ * but q must be a different polynomial
+ */
+template <typename T, typename U>
+FGS_CONSTEXPR void divmod (const Polynomial<T>& a, const Polynomial<U>& b, Polynomial<T>& q, Polynomial<T>& r){
+    FGS_INSTRUMENT_SCOPE(division);
+    q.var = r.var = a.var;
+    auto &quotient = q.write();
+    auto &remainder = r.write();
+    kernels::divmod(a.read(), b.read(), quotient, remainder);
+}
+
+template <typename T, typename U>
+FGS_CONSTEXPR auto divmod (const Polynomial<T>& a, const Polynomial<U>& b){
+    using CommonType = std::common_type_t<T, U>;
+    std::pair<Polynomial<CommonType>, Polynomial<CommonType>> ret;
+    divmod(Polynomial<CommonType>(a), b, ret.first, ret.second);
+    return ret;
+}
+
+template <typename T, typename U>
+FGS_CONSTEXPR void differentiate_into (Polynomial<T>& out, const Polynomial<U>& a){
+    out.var = a.var;
+    auto &o = out.write();
+    kernels::differentiate_into(o, a.read());
+}
+
 template <typename CType1, typename CType2>
-bool operator==(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR bool operator==(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     using CommonType = std::common_type_t<CType1, CType2>;
     return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
         [](const CommonType& a, const CommonType& b){
@@ -436,7 +996,7 @@ bool operator==(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
 }
 
 template <typename CType1, typename CType2>
-bool operator!=(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
+FGS_CONSTEXPR bool operator!=(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
     return !(lhs == rhs);
 }
 
@@ -444,23 +1004,53 @@ bool operator!=(const Polynomial<CType1>& lhs, const Polynomial<CType2>& rhs){
  * (not modifying the original)
  */
 template <typename CType>
-Polynomial<CType> pow(const Polynomial<CType>& pol, unsigned n) {
+FGS_CONSTEXPR Polynomial<CType> pow(const Polynomial<CType>& pol, unsigned n) {
     return Polynomial<CType>(pol).pow(n);
 }
 
+/* Like Polynomial::taylor_shift, but returning an rvalue
+ * (not modifying the original)
+ */
+template <typename CType, typename U>
+FGS_CONSTEXPR Polynomial<CType> taylor_shift (const Polynomial<CType>& pol, const U& a){
+    return Polynomial<CType>(pol).taylor_shift(a);
+}
+
+/* Like Polynomial::scale, but returning an rvalue
+ * (not modifying the original)
+ */
+template <typename CType, typename U>
+FGS_CONSTEXPR Polynomial<CType> scale (const Polynomial<CType>& pol, const U& s){
+    return Polynomial<CType>(pol).scale(s);
+}
+
 /* Like Polynomial::differentiate, but returning an rvalue
  * (not modifying the original)
  */
 template <typename CType>
-Polynomial<CType> differentiate (const Polynomial<CType>& pol){
+FGS_CONSTEXPR Polynomial<CType> differentiate (const Polynomial<CType>& pol){
     return Polynomial<CType>(pol).differentiate();
 }
 
+// k-th derivative of pol (see Polynomial::derivative)
+template <typename CType>
+FGS_CONSTEXPR Polynomial<CType> derivative (const Polynomial<CType>& pol, std::size_t k){
+    Polynomial<CType> ret;
+    pol.derivative(k, ret);
+    return ret;
+}
+
+// Same, written into out (whose storage is reused)
+template <typename CType>
+FGS_CONSTEXPR void derivative (const Polynomial<CType>& pol, std::size_t k, Polynomial<CType>& out){
+    pol.derivative(k, out);
+}
+
 /* Like Polynomial::integrate_const, but returning an rvalue
  * (not modifying the original)
  */
 template <typename CType>
-Polynomial<CType> integrate_const (const Polynomial<CType>& pol, const CType& c = CType(0)){
+FGS_CONSTEXPR Polynomial<CType> integrate_const (const Polynomial<CType>& pol, const CType& c = CType(0)){
     return Polynomial<CType>(pol).integrate_const(c);
 }
 
@@ -468,7 +1058,7 @@ Polynomial<CType> integrate_const (const Polynomial<CType>& pol, const CType& c
  * (not modifying the original)
  */
 template <typename CType, typename RType>
-Polynomial<CType> integrate_point (const Polynomial<CType>& pol, const RType& x, const RType& y){
+FGS_CONSTEXPR Polynomial<CType> integrate_point (const Polynomial<CType>& pol, const RType& x, const RType& y){
     return Polynomial<CType>(pol).integrate_point(x, y);
 }
 
@@ -476,20 +1066,308 @@ Polynomial<CType> integrate_point (const Polynomial<CType>& pol, const RType& x,
  * polynomial. RType is the type of the evaluation
  */
 template <typename CType, typename RType>
-auto definite_integral (const Polynomial<CType>& pol, const RType& lower_bound, const RType& upper_bound){
+FGS_CONSTEXPR auto definite_integral (const Polynomial<CType>& pol, const RType& lower_bound, const RType& upper_bound){
     Polynomial<CType> p(pol);
     p.integrate_const();
     return p.evaluate_at(upper_bound) - p.evaluate_at(lower_bound);
 }
 
-// GCD of two polynomials using Euclidean's algorithm
+namespace gcd_aux{
+    /* The half-gcd only pays off with exact coefficients: with floating-point
+     * ones every remainder is tainted by rounding, and the Euclidean
+     * algorithm is as good as it gets. Integers go through the multi-modular
+     * gcd instead
+     */
+    template <typename CType>
+    inline constexpr bool use_half_gcd_v = !std::is_floating_point_v<detail::reduce_complex_t<CType>> &&
+                                           !std::is_integral_v<CType>;
+
+    // 2x2 matrix of polynomials, stored by rows
+    template <typename CType>
+    using Matrix = std::array<Polynomial<CType>, 4>;
+
+    template <typename CType>
+    bool is_zero (const Polynomial<CType>& p){
+        return p.degree() == 0 && p[0] == CType(0);
+    }
+
+    // Quotient of p by x^k
+    template <typename CType>
+    Polynomial<CType> shift_down (const Polynomial<CType>& p, std::size_t k){
+        return (k > p.degree()) ? Polynomial<CType>() : Polynomial<CType>(std::next(p.begin(), k), p.end());
+    }
+
+    template <typename CType>
+    Matrix<CType> identity (){
+        return {Polynomial<CType>(CType(1)), Polynomial<CType>(), Polynomial<CType>(), Polynomial<CType>(CType(1))};
+    }
+
+    template <typename CType>
+    Matrix<CType> multiply (const Matrix<CType>& lhs, const Matrix<CType>& rhs){
+        return {lhs[0]*rhs[0] + lhs[1]*rhs[2], lhs[0]*rhs[1] + lhs[1]*rhs[3],
+                lhs[2]*rhs[0] + lhs[3]*rhs[2], lhs[2]*rhs[1] + lhs[3]*rhs[3]};
+    }
+
+    // Replaces (a, b) with m*(a, b)
+    template <typename CType>
+    void apply (const Matrix<CType>& m, Polynomial<CType>& a, Polynomial<CType>& b){
+        auto c = m[0]*a + m[1]*b;
+        b = m[2]*a + m[3]*b;
+        a = std::move(c);
+    }
+
+    // Matrix of one Euclidean step: (a, b) -> (b, a - q*b)
+    template <typename CType>
+    Matrix<CType> euclidean_step (const Polynomial<CType>& q){
+        return {Polynomial<CType>(), Polynomial<CType>(CType(1)), Polynomial<CType>(CType(1)), -q};
+    }
+
+    /* Half-gcd (Thull and Yap's formulation). Being deg(a) > deg(b), returns
+     * the matrix m of the Euclidean steps such that m*(a, b) = (c, d) are
+     * consecutive remainders with deg(c) >= ceil(deg(a)/2) > deg(d).
+     *
+     * Each half is solved recursively on the leading coefficients only, so
+     * the cost is O(M(n) log n) instead of O(n^2)
+     */
+    template <typename CType>
+    Matrix<CType> half_gcd (const Polynomial<CType>& a, const Polynomial<CType>& b){
+        const std::size_t m = (a.degree()+1)/2;
+        if (is_zero(b) || b.degree() < m)
+            return identity<CType>();
+
+        if (a.degree() < tuning::threshold<CType>(tuning::Threshold::half_gcd)){
+            auto ret = identity<CType>();
+            Polynomial<CType> c(a), d(b);
+
+            Polynomial<CType> q;
+            while (!is_zero(d) && d.degree() >= m){
+                divmod(c, d, q, c);
+                ret = multiply(euclidean_step(q), ret);
+                swap(c, d);
+            }
+
+            return ret;
+        }
+
+        const auto r = half_gcd(shift_down(a, m), shift_down(b, m));
+        Polynomial<CType> c(a), d(b);
+        apply(r, c, d);
+
+        if (is_zero(d) || d.degree() < m)
+            return r;
+
+        Polynomial<CType> q;
+        divmod(c, d, q, c);
+        swap(c, d);
+
+        const std::size_t k = 2*m - c.degree();
+        return multiply(multiply(half_gcd(shift_down(c, k), shift_down(d, k)), euclidean_step(q)), r);
+    }
+
+    // Euclidean algorithm with half-gcd jumps, for deg(lhs) >= deg(rhs)
+    template <typename CType>
+    Polynomial<CType> fast_gcd (Polynomial<CType> lhs, Polynomial<CType> rhs){
+        while (!is_zero(rhs)){
+            lhs %= rhs;
+            swap(lhs, rhs);
+
+            if (is_zero(rhs) || lhs.degree() < tuning::threshold<CType>(tuning::Threshold::half_gcd))
+                continue;
+
+            apply(half_gcd(lhs, rhs), lhs, rhs);
+        }
+
+        return lhs;
+    }
+
+#ifdef __SIZEOF_INT128__
+    // Content (positive gcd of the coefficients) of an integer polynomial
+    template <typename CType>
+    CType content (const Polynomial<CType>& p){
+        CType ret(0);
+        for (const auto &elem : p)
+            ret = std::gcd(ret, elem);
+        return ret;
+    }
+
+    template <typename CType>
+    Polynomial<CType> primitive_part (Polynomial<CType> p, const CType& c){
+        for (auto &elem : p)
+            elem /= c;
+        return p;
+    }
+
+    /* Whether d divides p in Z[x], by long division in 128-bit integers
+     * (an overflow means it doesn't, as the quotient would not fit)
+     */
+    template <typename CType>
+    bool divides (const std::vector<multimodular_aux::int128>& d, const Polynomial<CType>& p){
+        if (p.degree()+1 < d.size())
+            return false;
+
+        std::vector<multimodular_aux::int128> r(p.begin(), p.end());
+        for (std::size_t i=r.size()-d.size()+1; i-- > 0;){
+            if (r[i+d.size()-1] % d.back() != 0)
+                return false;
+
+            const multimodular_aux::int128 q = r[i+d.size()-1]/d.back();
+            for (std::size_t j=0; j<d.size(); ++j){
+                multimodular_aux::int128 t;
+                if (__builtin_mul_overflow(q, d[j], &t) || __builtin_sub_overflow(r[i+j], t, &r[i+j]))
+                    return false;
+            }
+        }
+
+        return std::all_of(r.begin(), r.begin()+d.size()-1, [](const auto& x){ return x == 0; });
+    }
+
+    /* Primitive integer polynomial (positive leading coefficient) whose
+     * monic associate has the coefficients accumulated in acc, if rational
+     * reconstruction succeeds and nothing overflows
+     */
+    inline bool reconstruct (const std::vector<multimodular_aux::crt_accumulator>& acc,
+                             std::vector<multimodular_aux::int128>& ret){
+        using multimodular_aux::int128;
+
+        std::vector<int128> num(acc.size()), den(acc.size());
+        int128 common = 1;
+        for (std::size_t i=0; i<acc.size(); ++i){
+            if (!multimodular_aux::rational_reconstruction(acc[i], num[i], den[i]))
+                return false;
+            if (__builtin_mul_overflow(common/multimodular_aux::gcd(common, den[i]), den[i], &common))
+                return false;
+        }
+
+        int128 c = 0;
+        ret.resize(acc.size());
+        for (std::size_t i=0; i<acc.size(); ++i){
+            if (__builtin_mul_overflow(num[i], common/den[i], &ret[i]))
+                return false;
+            c = multimodular_aux::gcd(c, ret[i]);
+        }
+
+        for (auto &elem : ret)
+            elem /= c;
+
+        return true;
+    }
+
+    /* Multi-modular gcd of integer polynomials: the monic gcd of the
+     * primitive parts is computed modulo several primes in parallel, lifted
+     * with the Chinese remainder theorem and rational reconstruction, and
+     * checked by trial division. Images of unlucky primes (those dividing a
+     * leading coefficient or giving a gcd of too high degree) are dropped.
+     *
+     * Throws std::overflow_error if the gcd can't be recovered with 128-bit
+     * integers
+     */
+    template <typename CType>
+    Polynomial<CType> multimodular_gcd (const Polynomial<CType>& lhs, const Polynomial<CType>& rhs){
+        using multimodular_aux::PRIMES;
+
+        const CType cl = content(lhs), cr = content(rhs), c = std::gcd(cl, cr);
+        const auto f = primitive_part(lhs, cl), g = primitive_part(rhs, cr);
+
+        // Monic gcd of f and g modulo one prime, empty if the prime is unlucky
+        const auto image = [&f, &g](auto prime){
+            using Mod = ModInt<decltype(prime)::value>;
+
+            std::vector<std::uint32_t> ret;
+            if (Mod(f.last()) == Mod(0) || Mod(g.last()) == Mod(0))
+                return ret;
+
+            const auto h = gcd(Polynomial<Mod>(f.begin(), f.end()), Polynomial<Mod>(g.begin(), g.end()));
+            const Mod inverse = h.last().inverse();
+            for (const auto &elem : h)
+                ret.push_back((elem*inverse).value());
+
+            return ret;
+        };
+
+        Polynomial<CType> ret(c);
+        ret.set_variable(lhs.get_variable());
+
+        const std::size_t batch = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<multimodular_aux::crt_accumulator> acc;
+        std::vector<multimodular_aux::int128> candidate;
+        std::size_t degree = std::min(f.degree(), g.degree()), used = 0;
+
+        for (std::size_t first=0; first<PRIMES.size(); first+=batch){
+            const auto images = multimodular_aux::map_primes(first, std::min(batch, PRIMES.size()-first), image);
+
+            for (std::size_t k=0; k<images.size(); ++k){
+                const auto &h = images[k];
+                if (h.empty() || h.size()-1 > degree)
+                    continue;
+                // Good primes never give a constant gcd when the true one isn't
+                if (h.size() == 1)
+                    return ret;
+                if (h.size()-1 < degree || acc.empty()){
+                    degree = h.size()-1;
+                    acc.assign(h.size(), multimodular_aux::crt_accumulator());
+                    used = 0;
+                }
+                if (used == multimodular_aux::MAX_COMBINED_PRIMES)
+                    continue;
+
+                for (std::size_t i=0; i<h.size(); ++i)
+                    acc[i].add(h[i], PRIMES[first+k]);
+                ++used;
+
+                if (!reconstruct(acc, candidate) || !divides(candidate, f) || !divides(candidate, g))
+                    continue;
+
+                std::vector<CType> coeffs(candidate.size());
+                for (std::size_t i=0; i<candidate.size(); ++i){
+                    if (__builtin_mul_overflow(candidate[i], multimodular_aux::int128(c), &candidate[i]))
+                        throw std::overflow_error("fgs::gcd: coefficients too large for the coefficient type");
+                    coeffs[i] = multimodular_aux::to_integer<CType>(candidate[i]);
+                }
+
+                ret = Polynomial<CType>(coeffs.begin(), coeffs.end());
+                ret.set_variable(lhs.get_variable());
+                return ret;
+            }
+        }
+
+        throw std::overflow_error("fgs::gcd: coefficients too large for 128-bit reconstruction");
+    }
+#endif
+}
+
+/* GCD of two polynomials using Euclidean's algorithm
+ *
+ * With exact coefficient types (see ModInt) the Euclidean steps are
+ * grouped by the half-gcd algorithm, so large inputs cost O(M(n) log^2 n).
+ * Signed integer coefficients use the multi-modular gcd, which is exact:
+ * the result is the primitive gcd (positive leading coefficient) times the
+ * gcd of the contents
+ */
 template <typename CType>
-Polynomial<CType> gcd (Polynomial<CType> lhs, Polynomial<CType> rhs){
+FGS_CONSTEXPR Polynomial<CType> gcd (Polynomial<CType> lhs, Polynomial<CType> rhs){
+    FGS_INSTRUMENT_SCOPE(gcd);
+
     if (lhs==Polynomial<CType>())
         return rhs;
     if (rhs==Polynomial<CType>())
         return lhs;
 
+    // The exact algorithm for integers can't run at compile time, and Euclid's would truncate
+    if constexpr (std::is_integral_v<CType>)
+        if (detail::is_constant_evaluated())
+            throw std::logic_error("fgs::gcd: integer coefficients are not supported in constant expressions");
+
+#ifdef __SIZEOF_INT128__
+    if constexpr (multimodular_aux::is_supported_v<CType>)
+        return gcd_aux::multimodular_gcd(lhs, rhs);
+#endif
+
+    if constexpr (gcd_aux::use_half_gcd_v<CType>)
+        if (!detail::is_constant_evaluated() &&
+            std::max(lhs.degree(), rhs.degree()) >= tuning::threshold<CType>(tuning::Threshold::half_gcd))
+            return (lhs.degree() >= rhs.degree()) ? gcd_aux::fast_gcd(std::move(lhs), std::move(rhs))
+                                                  : gcd_aux::fast_gcd(std::move(rhs), std::move(lhs));
+
     while (rhs.degree()>0 || rhs[0]!=CType(0)){
         swap(lhs, rhs);
         rhs %= lhs;
@@ -498,10 +1376,116 @@ Polynomial<CType> gcd (Polynomial<CType> lhs, Polynomial<CType> rhs){
     return lhs;
 }
 
-// LCM of two polynomials using Euclidean's algorithm
+/* LCM of two polynomials using Euclidean's algorithm. With signed integer
+ * coefficients the division by the gcd is exact
+ */
 template <typename CType>
-const Polynomial<CType> lcm (const Polynomial<CType>& lhs, const Polynomial<CType>& rhs){
-    return (lhs/gcd(lhs, rhs))*rhs;
+FGS_CONSTEXPR const Polynomial<CType> lcm (const Polynomial<CType>& lhs, const Polynomial<CType>& rhs){
+    Polynomial<CType> ret(lhs);
+    ret /= gcd(lhs, rhs);
+    return ret *= rhs;
+}
+
+namespace compose_aux{
+    // Number of coefficients of the outer polynomial composed directly with Horner
+    inline static constexpr std::size_t HORNER_THRESHOLD = 8;
+
+    /* Composes the coefficients [first, last) of f with g, where powers[k]
+     * holds g^(2^k). The range is split at a power of two, so
+     *
+     *   f_low(g) + g^(2^k)*f_high(g)
+     *
+     * only needs products of balanced sizes
+     */
+    template <typename CType>
+    FGS_CONSTEXPR Polynomial<CType> compose_range (const Polynomial<CType>& f, std::size_t first, std::size_t last,
+                                     const Polynomial<CType>& g, const std::vector<Polynomial<CType>>& powers){
+        if (last - first <= HORNER_THRESHOLD){
+            Polynomial<CType> res(f[last-1]);
+
+            for (std::size_t i=last-1; i>first; --i){
+                res *= g;
+                res += f[i-1];
+            }
+
+            return res;
+        }
+
+        std::size_t k = 0;
+        while ((std::size_t(2) << k) < last - first)
+            ++k;
+
+        const std::size_t middle = first + (std::size_t(1) << k);
+        auto res = compose_range(f, first, middle, g, powers);
+        res += powers[k]*compose_range(f, middle, last, g, powers);
+
+        return res;
+    }
+}
+
+/* Composition of two polynomials (the result is f(g(x)))
+ *
+ * Divide and conquer over the coefficients of f, so the cost is
+ * O(M(deg(f)*deg(g)) log(deg(f))) instead of the deg(f) products of
+ * growing size done by Horner's scheme
+ */
+template <typename CType1, typename CType2>
+FGS_CONSTEXPR auto compose (const Polynomial<CType1>& f, const Polynomial<CType2>& g){
+    FGS_INSTRUMENT_SCOPE(composition);
+
+    using CommonType = std::common_type_t<CType1, CType2>;
+    const Polynomial<CommonType> outer(f), inner(g);
+    const std::size_t n = outer.degree()+1;
+
+    // Powers g^(2^k) for every split point of compose_range
+    std::vector<Polynomial<CommonType>> powers{inner};
+    if (n > compose_aux::HORNER_THRESHOLD)
+        while ((std::size_t(1) << powers.size()) < n)
+            powers.push_back(powers.back()*powers.back());
+
+    auto res = compose_aux::compose_range(outer, 0, n, inner, powers);
+    res.set_variable(g.get_variable());
+    return res;
+}
+
+/* Modular composition (the result is f(g(x)) mod h), without building
+ * the polynomial f(g(x))
+ *
+ * Uses Brent-Kung's baby-step/giant-step scheme: with k = ceil(sqrt(deg(f)+1)),
+ * the baby steps g^i mod h (i < k) build each block of k coefficients of f
+ * with scalar products only, and the blocks are combined with Horner's
+ * scheme over the giant step g^k mod h. Only O(sqrt(deg(f))) products
+ * modulo h are needed
+ */
+template <typename CType1, typename CType2, typename CType3>
+auto compose_mod (const Polynomial<CType1>& f, const Polynomial<CType2>& g, const Polynomial<CType3>& h){
+    using CommonType = std::common_type_t<CType1, CType2, CType3>;
+    const Polynomial<CommonType> modulus(h);
+    const std::size_t n = f.degree()+1;
+
+    std::size_t k = 1;
+    while (k*k < n)
+        ++k;
+
+    std::vector<Polynomial<CommonType>> baby{Polynomial<CommonType>(CommonType(1)), Polynomial<CommonType>(g) % modulus};
+    baby.reserve(k+1);
+    for (std::size_t i=2; i<=k; ++i)
+        baby.push_back(baby.back()*baby[1] % modulus);
+
+    const Polynomial<CommonType> giant = std::move(baby.back());
+    baby.pop_back();
+
+    Polynomial<CommonType> res;
+    for (std::size_t j=(n-1)/k+1; j-- > 0;){
+        Polynomial<CommonType> block;
+        for (std::size_t i=0; i<k && j*k+i<n; ++i)
+            block += CommonType(f[j*k+i])*baby[i];
+
+        res = (res*giant + block) % modulus;
+    }
+
+    res.set_variable(g.get_variable());
+    return res;
 }
 
 namespace roots_aux{
@@ -534,57 +1518,134 @@ namespace roots_aux{
         );
     }
 
+    /* Radius that takes the roots of the monic polynomial p to the unit
+     * disk: max_k |a_{n-k}|^(1/k) (Fujiwara's bound without the factor 2)
+     */
+    inline long double roots_radius (const Polynomial<std::complex<long double>> &p){
+        long double radius = 0.0L;
+
+        for (std::size_t k=1; k<=p.degree(); ++k)
+            radius = std::max(radius, std::pow(std::abs(p[p.degree()-k]), 1.0L/static_cast<long double>(k)));
+
+        return (radius == 0.0L) ? 1.0L : radius;
+    }
+
+    /* Monic polynomial whose roots are the ones of p divided by radius. The
+     * scaling is done on the reversed coefficients, so nothing overflows
+     */
+    inline auto normalize_roots (const Polynomial<std::complex<long double>> &p, long double radius){
+        std::vector<std::complex<long double>> c(p.rbegin(), p.rend());
+        shift_aux::scale(c, std::complex<long double>(1.0L/radius));
+
+        return Polynomial<std::complex<long double>>(c.rbegin(), c.rend());
+    }
+
     inline auto generate_values (const Polynomial<std::complex<long double>> &p){
         using namespace std::complex_literals;
 
+        // The bounds are computed once the roots are centred at the origin
+        // and normalized to the unit disk, where they are much tighter
+        const auto centre = -p[p.degree()-1] / static_cast<long double>(p.degree());
+        const auto shifted = taylor_shift(p, centre);
+        const long double radius = roots_radius(shifted);
+        const auto normalized = normalize_roots(shifted, radius);
+
         long double
-            low = lower_bound_roots(p),
-            high = upper_bound_roots(p),
+            low = lower_bound_roots(normalized),
+            high = upper_bound_roots(normalized),
             mod = (low + high) / 2.0L;
 
         if (mod == 1.0L)
             mod -= (high - low) / 4.0L;
+        mod *= radius;
 
         auto rot = std::exp(1.0il * (TWO_PI / static_cast<long double>(p.degree())));
-        std::vector<std::complex<long double>> ret{mod*std::pow(rot, 0.25L)};
+        std::vector<std::complex<long double>> ret{centre + mod*std::pow(rot, 0.25L)};
         ret.reserve(p.degree());
 
         for (std::size_t i=1; i<p.degree(); ++i)
-            ret.push_back(ret[i-1] * rot);
+            ret.push_back(centre + (ret[i-1] - centre) * rot);
 
         return ret;
     }
 
+    // Maximum number of Newton's steps that polish each root found
+    inline static constexpr std::size_t POLISH_STEPS = 2;
+
+    /* Newton's steps on the root z of p, kept while they reduce |p(z)|.
+     * Durand-Kerner stops at TOLERANCE, and this takes simple roots to
+     * the working precision
+     */
+    inline std::complex<long double> polish (const Polynomial<std::complex<long double>> &p, std::complex<long double> z){
+        std::array<std::complex<long double>, 2> v, w;
+        p.evaluate_with_derivatives(z, 1, v.begin());
+
+        for (std::size_t it=0; it<POLISH_STEPS && v[0] != 0.0L && v[1] != 0.0L; ++it){
+            const auto next = z - v[0]/v[1];
+            p.evaluate_with_derivatives(next, 1, w.begin());
+            if (std::abs(w[0]) >= std::abs(v[0]))
+                break;
+
+            z = next;
+            v = w;
+        }
+
+        return z;
+    }
+
+    /* Durand-Kerner iteration. The roots and the coefficients are kept
+     * split in real and imaginary parts (see split_aux), so the O(n^2)
+     * products of differences are plain real arithmetic
+     */
     template <typename OutputIterator>
     void durand_kerner(const Polynomial<std::complex<long double>> &p, OutputIterator out){
-        std::vector<std::pair<std::complex<long double>, std::complex<long double>>> ret;
-        ret.reserve(p.degree());
+        FGS_INSTRUMENT_ROOT_CALL();
 
-        for (auto && elem : generate_values(p))
-            ret.emplace_back(std::complex<long double>{}, elem);
+        const auto values = generate_values(p);
+        const std::size_t n = values.size();
 
-        while (!std::all_of(ret.begin(), ret.end(),
-            [](const auto &e){
-                return std::abs(e.second - e.first) < TOLERANCE;
-            }))
-        {
-            for (std::size_t i=0; i<ret.size(); ++i){
-                ret[i].first = ret[i].second;
-                std::complex<long double> aux{1.0L};
-
-                for (std::size_t j=0; j<i; ++j)
-                    aux *= (ret[i].second - ret[j].second);
-                for (std::size_t j=i+1; j<ret.size(); ++j)
-                    aux *= (ret[i].second - ret[j].second);
+        std::vector<long double> re(p.degree()+1), im(p.degree()+1), zr(n), zi(n), prev_r(n), prev_i(n, 0.0L);
+        for (std::size_t k=0; k<=p.degree(); ++k){
+            re[k] = p[k].real();
+            im[k] = p[k].imag();
+        }
+        for (std::size_t i=0; i<n; ++i){
+            zr[i] = values[i].real();
+            zi[i] = values[i].imag();
+        }
 
-                ret[i].second -= p(ret[i].second) / aux;
+        const auto converged = [&](){
+            for (std::size_t i=0; i<n; ++i)
+                if (std::abs(std::complex<long double>(zr[i] - prev_r[i], zi[i] - prev_i[i])) >= TOLERANCE)
+                    return false;
+            return true;
+        };
+
+        while (!converged()){
+            FGS_INSTRUMENT_ROOT_ITERATION();
+            FGS_INSTRUMENT_FLOPS(n*(n+p.degree()));
+
+            for (std::size_t i=0; i<n; ++i){
+                prev_r[i] = zr[i];
+                prev_i[i] = zi[i];
+                long double ar = 1.0L, ai = 0.0L;
+
+                for (std::size_t j=0; j<n; ++j)
+                    if (j != i)
+                        split_aux::multiply(ar, ai, zr[i] - zr[j], zi[i] - zi[j], ar, ai);
+
+                long double yr, yi, qr, qi;
+                split_aux::horner(re, im, zr[i], zi[i], yr, yi);
+                split_aux::divide(yr, yi, ar, ai, qr, qi);
+                zr[i] -= qr;
+                zi[i] -= qi;
             }
         }
 
-        *out = ret.front().second;
-        for (auto it = std::next(ret.begin()); it != ret.end(); ++it)
-            *++out = it->second;
-        }
+        *out = polish(p, std::complex<long double>(zr[0], zi[0]));
+        for (std::size_t i=1; i<n; ++i)
+            *++out = polish(p, std::complex<long double>(zr[i], zi[i]));
+    }
 
     template <typename OutputIterator>
     void roots_of_impl (const Polynomial<std::complex<long double>> &p, OutputIterator out){
@@ -606,6 +1667,8 @@ namespace roots_aux{
 
 template <typename CType, typename OutputIterator>
 void roots_of(const Polynomial<CType>& p, OutputIterator out){
+    FGS_INSTRUMENT_SCOPE(roots);
+
     auto aux =  static_cast<Polynomial<std::complex<long double>>>(p) /
                 static_cast<std::complex<long double>>(p.last());
 
@@ -620,17 +1683,159 @@ auto roots_of (const Polynomial<CType>& pol) {
     return roots;
 }
 
+namespace product_tree_aux{
+    // Number of leaves from which the left subtree is built on its own thread
+    inline static constexpr std::size_t PARALLEL_THRESHOLD = 1024;
+}
+
+/* Subproduct tree of the linear factors (x - points[i])
+ *
+ * Level 0 holds the linear factors and node j of level k is the product of
+ * nodes 2j and 2j+1 of level k-1 (a node without sibling is carried up as
+ * it is), so the last level holds the product of every factor. The tree is
+ * balanced, so the products are of similar sizes (O(M(n) log n) in total)
+ * and the independent subtrees are built on separate threads.
+ *
+ * Once built, the same tree is used for multipoint evaluation (remainder
+ * tree) and interpolation at its points
+ */
+template <typename CType>
+class ProductTree{
+public:
+    using polynomial_type   = Polynomial<CType>;
+    using size_type         = std::size_t;
+
+    template <typename InputIt>
+    ProductTree (InputIt first, InputIt last)
+        : points(first, last)
+    {
+        levels.emplace_back(std::max<size_type>(points.size(), 1), polynomial_type{CType(1)});
+        while (levels.back().size() > 1)
+            levels.emplace_back((levels.back().size()+1)/2);
+
+        if (!points.empty())
+            build(levels.size()-1, 0, std::thread::hardware_concurrency());
+    }
+
+    template <template<typename...> typename Cont>
+    explicit ProductTree (const Cont<CType>& v)
+        : ProductTree(v.begin(), v.end()) {}
+
+    ProductTree (std::initializer_list<CType> l)
+        : ProductTree(l.begin(), l.end()) {}
+
+    // Product of every linear factor
+    const polynomial_type& root () const noexcept{ return levels.back().front(); }
+
+    // Number of levels, being level(height()-1) the one with the root
+    size_type height () const noexcept{ return levels.size(); }
+    const std::vector<polynomial_type>& level (size_type k) const{ return levels[k]; }
+
+    const std::vector<CType>& nodes () const noexcept{ return points; }
+
+    /* Values of pol at every point of the tree, reducing pol modulo the
+     * nodes from the root down to the leaves
+     */
+    template <typename CType2>
+    auto evaluate (const Polynomial<CType2>& pol) const{
+        using CommonType = std::common_type_t<CType, CType2>;
+        std::vector<CommonType> values(points.size());
+
+        if (!points.empty())
+            evaluate(levels.size()-1, 0, Polynomial<CommonType>(pol) % root(), values);
+
+        return values;
+    }
+
+    /* Polynomial of degree lower than nodes().size() that takes the values
+     * [first, last) at the points of the tree. The weights 1/root'(points[i])
+     * come from a multipoint evaluation, and the Lagrange terms are combined
+     * up the tree
+     */
+    template <typename InputIt>
+    polynomial_type interpolate (InputIt first, InputIt last) const{
+        if (points.empty())
+            return polynomial_type();
+
+        auto weights = evaluate(differentiate(root()));
+        for (size_type i=0; i<weights.size() && first != last; ++i, ++first)
+            weights[i] = CType(*first)/weights[i];
+
+        return combine(levels.size()-1, 0, weights);
+    }
+
+    template <template<typename...> typename Cont, typename RType>
+    polynomial_type interpolate (const Cont<RType>& v) const{
+        return interpolate(v.begin(), v.end());
+    }
+
+private:
+    std::vector<CType> points;                          // Roots of the linear factors
+    std::vector<std::vector<polynomial_type>> levels;   // Level 0 holds the leaves
+
+    void build (size_type k, size_type j, unsigned threads){
+        if (k == 0){
+            levels[0][j] = polynomial_type{-points[j], CType(1)};
+            return;
+        }
+
+        const bool has_sibling = 2*j+1 < levels[k-1].size();
+
+        if (has_sibling && threads > 1 && (size_type(1) << k) >= product_tree_aux::PARALLEL_THRESHOLD){
+            auto left = std::async(std::launch::async, [this, k, j, threads](){
+                build(k-1, 2*j, threads/2);
+            });
+            build(k-1, 2*j+1, threads - threads/2);
+            left.get();
+        }
+        else{
+            build(k-1, 2*j, threads);
+            if (has_sibling)
+                build(k-1, 2*j+1, threads);
+        }
+
+        levels[k][j] = has_sibling ? levels[k-1][2*j]*levels[k-1][2*j+1] : levels[k-1][2*j];
+    }
+
+    template <typename CommonType>
+    void evaluate (size_type k, size_type j, const Polynomial<CommonType>& rem,
+                   std::vector<CommonType>& values) const{
+        const size_type first = j << k, last = std::min(points.size(), (j+1) << k);
+
+        if (k == 0 || last - first < tuning::threshold<CommonType>(tuning::Threshold::evaluation)){
+            for (size_type i=first; i<last; ++i)
+                values[i] = rem.evaluate_at(points[i]);
+            return;
+        }
+
+        evaluate(k-1, 2*j, rem % levels[k-1][2*j], values);
+        if (2*j+1 < levels[k-1].size())
+            evaluate(k-1, 2*j+1, rem % levels[k-1][2*j+1], values);
+    }
+
+    polynomial_type combine (size_type k, size_type j, const std::vector<CType>& weights) const{
+        if (k == 0)
+            return polynomial_type(weights[j]);
+        if (2*j+1 >= levels[k-1].size())
+            return combine(k-1, 2*j, weights);
+
+        auto ret = combine(k-1, 2*j, weights)*levels[k-1][2*j+1];
+        ret += combine(k-1, 2*j+1, weights)*levels[k-1][2*j];
+
+        return ret;
+    }
+};
+
 // A set of functions to construct a polynomial
 
+/* Product of the linear factors (x - r) for every r in [first, last),
+ * built as a balanced product tree (see ProductTree)
+ */
 template <typename InputIt>
 auto make_polynomial_by_roots(InputIt first, InputIt last){
     using CType = typename std::iterator_traits<InputIt>::value_type;
 
-    Polynomial<CType> ret{CType(1)};
-    for (; first != last; ++first)
-        ret *= Polynomial<CType>{-CType(*first), CType(1)};
-
-    return ret;
+    return ProductTree<CType>(first, last).root();
 }
 
 template <typename CType, template<typename...> typename Cont>
@@ -647,7 +1852,7 @@ namespace lagrange_aux{
     // If it is not in [first, last), then behaviour is undefined
     // If two elements in [first, last) are equal, then behaviour is undefined
     template <typename InputIt>
-    auto lagrange_base (InputIt first, InputIt last, InputIt it){
+    FGS_CONSTEXPR auto lagrange_base (InputIt first, InputIt last, InputIt it){
         using CType = typename std::iterator_traits<InputIt>::value_type;
         Polynomial<CType> p{CType(1)};
 
@@ -663,7 +1868,7 @@ namespace lagrange_aux{
     // If nodes.size() <= i, then behaviour is undefined
     // If nodes[j] == nodes[k] for some j != k, then behaviour is undefined
     template <typename CType, template<typename...> typename Cont>
-    auto lagrange_base (const Cont<CType>& nodes, typename Cont<CType>::size_type i){
+    FGS_CONSTEXPR auto lagrange_base (const Cont<CType>& nodes, typename Cont<CType>::size_type i){
         Polynomial<CType> p{CType(1)};
 
         for (decltype(i) j=0; j < i; ++j)
@@ -678,7 +1883,7 @@ namespace lagrange_aux{
 
 // If distance(first1, last1) != distance(first2, last2), then behaviour is undefined
 template <typename InputIt1, typename InputIt2>
-auto lagrange_polynomial (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2){
+FGS_CONSTEXPR auto lagrange_polynomial (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2){
     using CommonType = std::common_type_t<traits_type<InputIt1>, traits_type<InputIt2>>;
     Polynomial<CommonType> p{CommonType(0)};
 
@@ -690,7 +1895,7 @@ auto lagrange_polynomial (InputIt1 first1, InputIt1 last1, InputIt2 first2, Inpu
 
 // If vx.size() != vy.size(), then behaviour is undefined
 template <typename DType, typename RType, template<typename...> typename Cont1, template<typename...> typename Cont2>
-auto lagrange_polynomial (const Cont1<DType>& vx, const Cont2<RType>& vy){
+FGS_CONSTEXPR auto lagrange_polynomial (const Cont1<DType>& vx, const Cont2<RType>& vy){
     using CommonType = std::common_type_t<DType, RType>;
     Polynomial<CommonType> p{CommonType(0)};
 
@@ -702,25 +1907,25 @@ auto lagrange_polynomial (const Cont1<DType>& vx, const Cont2<RType>& vy){
 
 // If vx.size() != vy.size(), then behaviour is undefined
 template <typename DType, typename RType>
-auto lagrange_polynomial (std::initializer_list<DType> vx, std::initializer_list<RType> vy){
+FGS_CONSTEXPR auto lagrange_polynomial (std::initializer_list<DType> vx, std::initializer_list<RType> vy){
     return lagrange_polynomial(vx.begin(), vx.end(), vy.begin(), vy.end());
 }
 
 // If vx.size() != vy.size(), then behaviour is undefined
 template <typename DType, typename RType, template<typename...> typename Cont>
-auto lagrange_polynomial (const Cont<DType>& vx, std::initializer_list<RType> vy){
+FGS_CONSTEXPR auto lagrange_polynomial (const Cont<DType>& vx, std::initializer_list<RType> vy){
     return lagrange_polynomial(vx.begin(), vx.end(), vy.begin(), vy.end());
 }
 
 // If vx.size() != vy.size(), then behaviour is undefined
 template <typename DType, typename RType, template<typename...> typename Cont>
-auto lagrange_polynomial (std::initializer_list<DType> vx, const Cont<RType>& vy){
+FGS_CONSTEXPR auto lagrange_polynomial (std::initializer_list<DType> vx, const Cont<RType>& vy){
     return lagrange_polynomial(vx.begin(), vx.end(), vy.begin(), vy.end());
 }
 
 template <typename DType, typename Func, template<typename...> typename Cont = std::vector,
             typename = std::enable_if_t<std::is_invocable_v<Func, DType>>>
-auto lagrange_polynomial (const Cont<DType>& nodes, Func&& f){
+FGS_CONSTEXPR auto lagrange_polynomial (const Cont<DType>& nodes, Func&& f){
     std::vector<std::invoke_result_t<Func, DType>> img(nodes.size());
     std::transform(nodes.begin(), nodes.end(), img.begin(), std::forward<Func>(f));
 
@@ -729,7 +1934,7 @@ auto lagrange_polynomial (const Cont<DType>& nodes, Func&& f){
 
 template <typename InputIt, typename Func,
             typename = std::enable_if_t<std::is_invocable_v<Func, traits_type<InputIt>>>>
-auto lagrange_polynomial (InputIt first, InputIt last, Func&& f){
+FGS_CONSTEXPR auto lagrange_polynomial (InputIt first, InputIt last, Func&& f){
     std::vector<std::invoke_result_t<Func, traits_type<InputIt>>> img(std::distance(first, last));
     std::transform(first, last, img.begin(), std::forward<Func>(f));
 
@@ -738,46 +1943,126 @@ auto lagrange_polynomial (InputIt first, InputIt last, Func&& f){
 
 template <typename DType, typename Func,
             typename = std::enable_if_t<std::is_invocable_v<Func, DType>>>
-auto lagrange_polynomial (std::initializer_list<DType> nodes, Func&& f){
+FGS_CONSTEXPR auto lagrange_polynomial (std::initializer_list<DType> nodes, Func&& f){
     return lagrange_polynomial(nodes.begin(), nodes.end(), std::forward<Func>(f));
 }
 
 namespace taylor_aux{
-    constexpr unsigned long factorial (unsigned long n){
-        return (n == 0) ? 1 : n*factorial(n-1);
+    /* Divides the k-th coefficient by k!, building 1/k! incrementally
+     *
+     * Floating-point coefficients are scaled in long double, where 1/k!
+     * stays representable for thousands of terms (k! itself overflows an
+     * unsigned long past k = 20). Throws std::domain_error if some k! is 0
+     * in T (ModInt<P> with P <= k)
+     */
+    template <typename T>
+    FGS_CONSTEXPR void divide_by_factorials (std::vector<T>& c){
+        using Real = detail::reduce_complex_t<T>;
+
+        if constexpr (std::is_floating_point_v<Real>){
+            using Wide = std::conditional_t<detail::is_complex_v<T>, std::complex<long double>, long double>;
+            long double inverse = 1.0L;
+
+            for (std::size_t k=1; k<c.size(); ++k){
+                inverse /= static_cast<long double>(k);
+                c[k] = T(Wide(c[k]) * inverse);
+            }
+        }
+        else{
+            if (!detail::factorials_invertible<T>(c.size()))
+                throw std::domain_error("fgs::taylor_polynomial: k! is zero in the coefficient field");
+
+            T inverse(1);
+
+            for (std::size_t k=1; k<c.size(); ++k){
+                inverse /= T(k);
+                c[k] *= inverse;
+            }
+        }
+    }
+
+    // Multiplies the k-th coefficient by k! (the inverse of divide_by_factorials)
+    template <typename T>
+    FGS_CONSTEXPR void multiply_by_factorials (std::vector<T>& c){
+        using Real = detail::reduce_complex_t<T>;
+
+        if constexpr (std::is_floating_point_v<Real>){
+            using Wide = std::conditional_t<detail::is_complex_v<T>, std::complex<long double>, long double>;
+            long double factorial = 1.0L;
+
+            for (std::size_t k=2; k<c.size(); ++k){
+                factorial *= static_cast<long double>(k);
+                c[k] = T(Wide(c[k]) * factorial);
+            }
+        }
+        else{
+            T factorial(1);
+
+            for (std::size_t k=2; k<c.size(); ++k){
+                factorial *= T(k);
+                c[k] *= factorial;
+            }
+        }
     }
 }
 
+/* Taylor polynomial centred at a, where [first, last) are the values of
+ * the derivatives f(a), f'(a), f''(a),...
+ *
+ * The scaled derivatives f^(k)(a)/k! are the coefficients of the expansion
+ * in powers of (x-a), so the monomial coefficients come out of a single
+ * Taylor shift by -a
+ */
 template <typename DType, typename InputIt>
-auto taylor_polynomial(DType a, InputIt first, InputIt last){
+FGS_CONSTEXPR auto taylor_polynomial(DType a, InputIt first, InputIt last){
     using CommonType = std::common_type_t<DType, typename std::iterator_traits<InputIt>::value_type>;
 
-    Polynomial<CommonType> ret{CommonType(*first)}, power{CommonType(1)}, aux{CommonType(-a), CommonType(1)};
-    for (++first; first != last; ++first){
-        power *= aux;
-        ret += power*(CommonType(*first)/CommonType(taylor_aux::factorial(power.degree())));
-    }
+    std::vector<CommonType> c;
+    for (; first != last; ++first)
+        c.push_back(CommonType(*first));
+
+    taylor_aux::divide_by_factorials(c);
 
+    return Polynomial<CommonType>(c.begin(), c.end()).taylor_shift(-CommonType(a));
+}
+
+/* Values of every derivative of pol at a: p(a), p'(a),..., p^(n)(a),
+ * written into out (resized to n+1, so its storage can be reused). It's
+ * the inverse of taylor_polynomial: the coefficients of p(x+a) are the
+ * scaled derivatives p^(k)(a)/k!, so it takes one Taylor shift, which is
+ * O(M(n)) for the coefficient types that shift by a product
+ */
+template <typename CType, typename U>
+FGS_CONSTEXPR void derivatives_at (const Polynomial<CType>& pol, const U& a, std::vector<CType>& out){
+    out.assign(pol.begin(), pol.end());
+    shift_aux::taylor_shift(out, CType(a));
+    taylor_aux::multiply_by_factorials(out);
+}
+
+template <typename CType, typename U>
+FGS_CONSTEXPR std::vector<CType> derivatives_at (const Polynomial<CType>& pol, const U& a){
+    std::vector<CType> ret;
+    derivatives_at(pol, a, ret);
     return ret;
 }
 
 template <typename DType, typename RType, template<typename...> typename Cont>
-auto taylor_polynomial(DType a, const Cont<RType>& v){
+FGS_CONSTEXPR auto taylor_polynomial(DType a, const Cont<RType>& v){
     return taylor_polynomial(a, v.begin(), v.end());
 }
 
 template <typename DType, typename RType>
-auto taylor_polynomial(DType a, std::initializer_list<RType> l){
+FGS_CONSTEXPR auto taylor_polynomial(DType a, std::initializer_list<RType> l){
     return taylor_polynomial(a, l.begin(), l.end());
 }
 
 template <typename CType>
-auto n_root_polynomial(unsigned n, CType a){
+FGS_CONSTEXPR auto n_root_polynomial(unsigned n, CType a){
     return Polynomial<CType>{0, 1}.pow(n) - Polynomial<CType>{a};
 }
 
 template <typename CType>
-auto cyclotomic_polynomial(unsigned n){
+FGS_CONSTEXPR auto cyclotomic_polynomial(unsigned n){
     if (n == 1)
         return Polynomial<CType>{-1, 1};
 
@@ -791,13 +2076,32 @@ auto cyclotomic_polynomial(unsigned n){
 }
 
 template <typename CType>
-auto monic_polynomial(const Polynomial<CType> &pol){
+FGS_CONSTEXPR auto monic_polynomial(const Polynomial<CType> &pol){
     return pol / pol.last();
 }
 
 template <typename CType>
-auto reduced_polynomial(const Polynomial<CType> &pol){
-    return monic_polynomial(pol)(Polynomial<CType>{-(pol[pol.degree()-1]/pol.last())/CType(pol.degree()), 1});
+FGS_CONSTEXPR auto reduced_polynomial(const Polynomial<CType> &pol){
+    return taylor_shift(monic_polynomial(pol), -(pol[pol.degree()-1]/pol.last())/CType(pol.degree()));
+}
+
+/* The N coefficients of pol (padded with zeros), lowest degree first.
+ * Memory allocated in a constant expression can't outlive it, so this is
+ * how a polynomial computed at compile time is kept in a constexpr
+ * variable (and turned back into a Polynomial at runtime):
+ *
+ *   constexpr auto phi12 = fgs::to_array<5>(fgs::cyclotomic_polynomial<int>(12));
+ *
+ * Throws std::length_error if pol has more than N coefficients
+ */
+template <std::size_t N, typename CType>
+FGS_CONSTEXPR std::array<CType, N> to_array (const Polynomial<CType>& pol){
+    if (pol.degree() >= N)
+        throw std::length_error("fgs::to_array: the polynomial doesn't fit in the array");
+
+    std::array<CType, N> ret{};
+    std::copy(pol.begin(), pol.end(), ret.begin());
+    return ret;
 }
 
 // Typedefs for coefficients in floating point (real numbers)
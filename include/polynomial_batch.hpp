@@ -0,0 +1,344 @@
+#pragma once
+
+#include "polynomial.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::max, std::fill
+#include <cstddef>      // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>    // std::out_of_range, std::length_error, std::invalid_argument
+#include <type_traits>  // std::conditional_t, std::common_type_t, std::enable_if_t
+
+namespace fgs{
+
+/* Class PolynomialView. Non-owning view of one polynomial of a
+ * PolynomialBatch, with the interface of a (fixed-capacity) Polynomial.
+ * Coefficient k lives stride elements after coefficient k-1.
+ *
+ * Const views only read. Views are invalidated by any operation that
+ * changes the degree or the size of the batch
+ */
+template <typename CType, bool Const>
+class PolynomialView{
+public:
+    using value_type        = CType;
+    using size_type         = std::size_t;
+    using pointer           = std::conditional_t<Const, const CType*, CType*>;
+    using reference         = std::conditional_t<Const, const CType&, CType&>;
+    using const_reference   = const CType&;
+
+    PolynomialView (pointer first, size_type step, size_type n, char variable) noexcept
+        : data(first), stride(step), capacity(n), var(variable) {}
+
+    // A mutable view can always be seen as a const one
+    operator PolynomialView<CType, true> () const noexcept{     // NOLINT(google-explicit-constructor)
+        return PolynomialView<CType, true>(data, stride, capacity, var);
+    }
+
+    reference operator[] (size_type i) const { return data[i*stride]; }
+
+    reference at (size_type i) const{
+        if (i >= capacity)
+            throw std::out_of_range("fgs::PolynomialView::at: coefficient out of range");
+        return (*this)[i];
+    }
+
+    reference first() const { return (*this)[0]; }
+    reference last() const { return (*this)[degree()]; }
+
+    char get_variable () const noexcept{ return var; }
+
+    // Degree of the polynomial (the padding zeros of the batch don't count)
+    size_type degree () const noexcept{
+        size_type d = capacity-1;
+        while (d > 0 && (*this)[d] == value_type(0))
+            --d;
+        return d;
+    }
+
+    // Highest degree the view can hold
+    size_type max_degree () const noexcept{ return capacity-1; }
+
+    // Horner's evaluation, as Polynomial::evaluate_at
+    template <typename RType>
+    auto evaluate_at (const RType& x) const{
+        using CommonType = std::common_type_t<value_type, RType>;
+        CommonType res((*this)[capacity-1]);
+
+        for (size_type i=capacity-1; i>0; --i)
+            res = CommonType((*this)[i-1]) + res*CommonType(x);
+
+        return res;
+    }
+
+    template <typename RType>
+    auto operator() (const RType& x) const{
+        return evaluate_at(x);
+    }
+
+    /* Overwrites the coefficients with the ones of pol. Throws
+     * std::length_error if pol doesn't fit in the view
+     */
+    template <typename CType2, bool C = Const, typename = std::enable_if_t<!C>>
+    const PolynomialView& assign (const Polynomial<CType2>& pol) const{
+        if (pol.degree() >= capacity)
+            throw std::length_error("fgs::PolynomialView::assign: polynomial degree exceeds the batch degree");
+
+        for (size_type i=0; i<capacity; ++i)
+            (*this)[i] = (i <= pol.degree()) ? value_type(pol[i]) : value_type(0);
+
+        return *this;
+    }
+
+    // Copy of the viewed polynomial
+    template <typename CType2>
+    explicit operator Polynomial<CType2> () const{
+        std::vector<CType2> c(capacity);
+        for (size_type i=0; i<capacity; ++i)
+            c[i] = CType2((*this)[i]);
+
+        Polynomial<CType2> ret(c.begin(), c.end());
+        ret.set_variable(var);
+        return ret;
+    }
+
+    Polynomial<CType> to_polynomial () const{
+        return this->operator Polynomial<CType>();
+    }
+
+private:
+    pointer data;           // Address of the independent coefficient
+    size_type stride;       // Distance between two consecutive coefficients
+    size_type capacity;     // Number of coefficients
+    char var;               // Letter that identifies the variable
+};
+
+/* Class PolynomialBatch. A set of polynomials of the same (maximum) degree
+ * stored as a structure of arrays: coefficient k of every polynomial is
+ * contiguous (row k), so the batch costs a single allocation and every
+ * operation runs over whole rows, in loops the compiler can vectorize
+ * across polynomials.
+ *
+ * Polynomials of lower degree are padded with zeros. Element i is accessed
+ * through a PolynomialView, without copying
+ */
+template <typename CType>
+class PolynomialBatch{
+public:
+    using container_type    = std::vector<CType>;
+    using value_type        = CType;
+    using size_type         = typename container_type::size_type;
+    using polynomial_type   = Polynomial<CType>;
+    using view              = PolynomialView<CType, false>;
+    using const_view        = PolynomialView<CType, true>;
+
+    // n zero polynomials, with room for the given degree
+    explicit PolynomialBatch (size_type n = 0, size_type degree = 0, char variable = 'x')
+        : coeffs(n*(degree+1), value_type(0)), count(n), rows(degree+1), var(variable) {}
+
+    // Batch with the polynomials of a range, with room for the highest degree
+    template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    PolynomialBatch (InputIt first, InputIt last){
+        const std::vector<polynomial_type> pols(first, last);
+
+        count = pols.size();
+        rows = 1;
+        for (const auto &p : pols)
+            rows = std::max<size_type>(rows, p.degree()+1);
+        if (!pols.empty())
+            var = pols.front().get_variable();
+
+        coeffs.assign(count*rows, value_type(0));
+        for (size_type i=0; i<count; ++i)
+            for (size_type k=0; k<=pols[i].degree(); ++k)
+                coeffs[k*count+i] = pols[i][k];
+    }
+
+    PolynomialBatch (std::initializer_list<polynomial_type> l)
+        : PolynomialBatch(l.begin(), l.end()) {}
+
+    view       operator[] (size_type i)       { return view(coeffs.data()+i, count, rows, var); }
+    const_view operator[] (size_type i) const { return const_view(coeffs.data()+i, count, rows, var); }
+
+    view at (size_type i){
+        check_index(i);
+        return (*this)[i];
+    }
+    const_view at (size_type i) const{
+        check_index(i);
+        return (*this)[i];
+    }
+
+    // Row k: coefficient k of every polynomial
+    value_type*       coefficients (size_type k)       { return coeffs.data() + k*count; }
+    const value_type* coefficients (size_type k) const { return coeffs.data() + k*count; }
+
+    size_type size () const noexcept{ return count; }
+    bool empty () const noexcept{ return count == 0; }
+
+    // Degree every polynomial of the batch has room for
+    size_type degree () const noexcept{ return rows-1; }
+
+    char get_variable () const noexcept{ return var; }
+    void set_variable (char c) noexcept{ var = c; }
+
+    /* Changes the degree the batch has room for. Growing pads with zeros,
+     * shrinking drops the highest coefficients
+     */
+    void resize_degree (size_type degree){
+        rows = degree+1;
+        coeffs.resize(count*rows, value_type(0));
+    }
+
+    // Every polynomial evaluated at the same x, by Horner's scheme over rows
+    template <typename RType>
+    auto evaluate_at (const RType& x) const{
+        using CommonType = std::common_type_t<value_type, RType>;
+        const CommonType cx(x);
+        std::vector<CommonType> ret(coefficients(rows-1), coefficients(rows-1)+count);
+
+        for (size_type k=rows-1; k>0; --k){
+            const value_type* row = coefficients(k-1);
+            for (size_type i=0; i<count; ++i)
+                ret[i] = CommonType(row[i]) + ret[i]*cx;
+        }
+
+        return ret;
+    }
+
+    // Polynomial i evaluated at x[i], by Horner's scheme over rows
+    template <typename RType>
+    auto evaluate_at (const std::vector<RType>& x) const{
+        using CommonType = std::common_type_t<value_type, RType>;
+        if (x.size() != count)
+            throw std::invalid_argument("fgs::PolynomialBatch::evaluate_at: one point per polynomial is needed");
+
+        std::vector<CommonType> ret(coefficients(rows-1), coefficients(rows-1)+count);
+        for (size_type k=rows-1; k>0; --k){
+            const value_type* row = coefficients(k-1);
+            for (size_type i=0; i<count; ++i)
+                ret[i] = CommonType(row[i]) + ret[i]*CommonType(x[i]);
+        }
+
+        return ret;
+    }
+
+    template <typename RType>
+    auto operator() (const RType& x) const{
+        return evaluate_at(x);
+    }
+
+    // Elementwise operations: polynomial i with polynomial i of rhs
+    PolynomialBatch& operator+= (const PolynomialBatch& rhs){
+        check_size(rhs);
+        if (rhs.rows > rows)
+            resize_degree(rhs.rows-1);
+
+        for (size_type j=0; j<rhs.coeffs.size(); ++j)
+            coeffs[j] += rhs.coeffs[j];
+
+        return *this;
+    }
+
+    PolynomialBatch& operator-= (const PolynomialBatch& rhs){
+        check_size(rhs);
+        if (rhs.rows > rows)
+            resize_degree(rhs.rows-1);
+
+        for (size_type j=0; j<rhs.coeffs.size(); ++j)
+            coeffs[j] -= rhs.coeffs[j];
+
+        return *this;
+    }
+
+    // Schoolbook product, each row of one operand against each row of the other
+    PolynomialBatch& operator*= (const PolynomialBatch& rhs){
+        check_size(rhs);
+        container_type res(count*(rows+rhs.rows-1), value_type(0));
+
+        for (size_type a=0; a<rows; ++a)
+            for (size_type b=0; b<rhs.rows; ++b){
+                const value_type *x = coefficients(a), *y = rhs.coefficients(b);
+                value_type* z = res.data() + (a+b)*count;
+
+                for (size_type i=0; i<count; ++i)
+                    z[i] += x[i]*y[i];
+            }
+
+        coeffs = std::move(res);
+        rows += rhs.rows-1;
+        return *this;
+    }
+
+    PolynomialBatch& operator*= (const value_type& s){
+        for (auto &elem : coeffs)
+            elem *= s;
+        return *this;
+    }
+
+    // Derivative of every polynomial, which lowers the degree of the batch by one
+    PolynomialBatch& differentiate (){
+        if (rows == 1){
+            std::fill(coeffs.begin(), coeffs.end(), value_type(0));
+            return *this;
+        }
+
+        for (size_type k=1; k<rows; ++k){
+            const value_type* src = coefficients(k);
+            value_type* dst = coefficients(k-1);
+            const value_type factor(k);
+
+            for (size_type i=0; i<count; ++i)
+                dst[i] = src[i]*factor;
+        }
+
+        resize_degree(rows-2);
+        return *this;
+    }
+
+    // Copies of the polynomials of the batch
+    std::vector<polynomial_type> to_polynomials () const{
+        std::vector<polynomial_type> ret;
+        ret.reserve(count);
+        for (size_type i=0; i<count; ++i)
+            ret.push_back((*this)[i].to_polynomial());
+        return ret;
+    }
+
+private:
+    container_type coeffs;  // Row k (coefficient k of every polynomial) after row k-1
+    size_type count = 0;    // Number of polynomials
+    size_type rows = 1;     // Number of coefficients of each polynomial
+    char var = 'x';         // Letter that identifies the variable
+
+    void check_index (size_type i) const{
+        if (i >= count)
+            throw std::out_of_range("fgs::PolynomialBatch::at: polynomial out of range");
+    }
+
+    void check_size (const PolynomialBatch& rhs) const{
+        if (rhs.count != count)
+            throw std::invalid_argument("fgs::PolynomialBatch: batches of different sizes");
+    }
+};
+
+template <typename CType>
+PolynomialBatch<CType> operator+ (PolynomialBatch<CType> lhs, const PolynomialBatch<CType>& rhs){
+    return lhs += rhs;
+}
+template <typename CType>
+PolynomialBatch<CType> operator- (PolynomialBatch<CType> lhs, const PolynomialBatch<CType>& rhs){
+    return lhs -= rhs;
+}
+template <typename CType>
+PolynomialBatch<CType> operator* (PolynomialBatch<CType> lhs, const PolynomialBatch<CType>& rhs){
+    return lhs *= rhs;
+}
+
+// Like PolynomialBatch::differentiate, but returning an rvalue
+template <typename CType>
+PolynomialBatch<CType> differentiate (PolynomialBatch<CType> batch){
+    return batch.differentiate();
+}
+
+}  // namespace fgs
@@ -1,58 +1,660 @@
 #include <iostream>
 #include <sstream>
+#include <array>        // std::array
+#include <charconv>     // std::from_chars, std::to_chars, std::chars_format
+#include <cmath>        // std::signbit
+#include <locale>       // std::locale, std::numpunct, std::use_facet
+#include <cstring>      // std::memchr
+#include <limits>       // std::numeric_limits
+#include <stdexcept>    // std::invalid_argument
+#include <string>       // std::string, std::to_string
+#include <string_view>  // std::string_view
+#include <system_error> // std::errc
+#include <type_traits>  // std::is_arithmetic_v, std::is_floating_point_v, std::is_integral_v
+#include <vector>       // std::vector
+#include <iterator>     // std::back_inserter
+#include <algorithm>    // std::count, std::copy, std::max
+#include <utility>      // std::move
+
+#if __has_include(<version>)
+#include <version>      // __cpp_lib_format
+#endif
+#ifdef __cpp_lib_format
+#include <format>       // std::formatter, std::format_parse_context, std::format_error
+#endif
 
 #include "detail.hpp"
 #include "polynomial.hpp"
 
 namespace fgs{
 
-/* TODO: Decide a good way to input a polynomial (or let the user
- * implement it itself).
+namespace io_aux{
+    inline bool is_letter (char c){
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    // 'e' and 'E' start the exponent of a number, so they can't be the variable
+    inline bool is_exponent_mark (char c){
+        return c == 'e' || c == 'E';
+    }
+
+    inline bool is_space (char c){
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // A number with an optional '+' (which std::from_chars doesn't accept)
+    template <typename T>
+    std::from_chars_result parse_number (const char* first, const char* last, T& x){
+        const char* p = (first != last && *first == '+') ? first+1 : first;
+        if (p != last && *p == '-' && p != first)
+            return {first, std::errc::invalid_argument};
+
+        const auto res = std::from_chars(p, last, x);
+        return (res.ec == std::errc()) ? res : std::from_chars_result{first, res.ec};
+    }
+
+    /* A coefficient as operator<< writes it: a number, or (real,imag) for
+     * complex types (which also accept a plain real number). Other types
+     * (like ModInt) are read as an integer and converted
+     */
+    template <typename T>
+    std::from_chars_result parse_coefficient (const char* first, const char* last, T& x){
+        if constexpr (detail::is_complex_v<T>){
+            using Real = detail::reduce_complex_t<T>;
+            Real re{}, im{};
+
+            if (first == last || *first != '('){
+                const auto res = parse_number(first, last, re);
+                if (res.ec == std::errc())
+                    x = T(re, Real(0));
+                return res;
+            }
+
+            auto res = parse_number(first+1, last, re);
+            if (res.ec != std::errc() || res.ptr == last || *res.ptr != ',')
+                return {first, (res.ec != std::errc()) ? res.ec : std::errc::invalid_argument};
+
+            res = parse_number(res.ptr+1, last, im);
+            if (res.ec != std::errc() || res.ptr == last || *res.ptr != ')')
+                return {first, (res.ec != std::errc()) ? res.ec : std::errc::invalid_argument};
+
+            x = T(re, im);
+            return {res.ptr+1, std::errc()};
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+            return parse_number(first, last, x);
+        else{
+            long long v = 0;
+            const auto res = parse_number(first, last, v);
+            if (res.ec == std::errc())
+                x = T(v);
+            return res;
+        }
+    }
+
+    /* Value of the superscript digit (UTF-8) at p, advancing p past it, or
+     * -1 if there is none: \u00B9, \u00B2 and \u00B3 take two bytes, the
+     * rest (\u2070, \u2074-\u2079) three
+     */
+    inline int superscript_digit (const char*& p, const char* last){
+        const auto byte = [](char c){ return static_cast<unsigned char>(c); };
+
+        if (last - p >= 2 && byte(p[0]) == 0xC2){
+            const int d = (byte(p[1]) == 0xB9) ? 1 : (byte(p[1]) == 0xB2) ? 2 : (byte(p[1]) == 0xB3) ? 3 : -1;
+            if (d > 0)
+                p += 2;
+            return d;
+        }
+        if (last - p >= 3 && byte(p[0]) == 0xE2 && byte(p[1]) == 0x81 &&
+                (byte(p[2]) == 0xB0 || (byte(p[2]) >= 0xB4 && byte(p[2]) <= 0xB9))){
+            const int d = (byte(p[2]) == 0xB0) ? 0 : byte(p[2]) - 0xB0;
+            p += 3;
+            return d;
+        }
+        return -1;
+    }
+
+    // Exponent after a variable: ^n, superscript digits or nothing (1)
+    inline std::from_chars_result parse_exponent (const char* first, const char* last, std::size_t& e){
+        if (first != last && *first == '^'){
+            if (first+1 == last || first[1] < '0' || first[1] > '9')
+                return {first, std::errc::invalid_argument};
+            return std::from_chars(first+1, last, e);
+        }
+
+        const char* p = first;
+        int d = superscript_digit(p, last);
+        if (d < 0){
+            e = 1;
+            return {first, std::errc()};
+        }
+
+        e = 0;
+        for (; d >= 0; d = superscript_digit(p, last)){
+            if (e > (std::numeric_limits<std::size_t>::max() - static_cast<std::size_t>(d))/10)
+                return {first, std::errc::result_out_of_range};
+            e = 10*e + static_cast<std::size_t>(d);
+        }
+        return {p, std::errc()};
+    }
+
+    /* Exponents up to this (or up to the length of the input, if it's
+     * longer) are accepted. The input is untrusted and x^n takes n+1
+     * coefficients, so "x^99999999999" must fail instead of allocating
+     */
+    inline constexpr std::size_t MAX_EXPONENT = std::size_t(1) << 20;
+
+    /* Parses the polynomial at [first, last) into c (coefficients, lowest
+     * degree first) and var. See fgs::from_chars
+     */
+    template <typename T>
+    std::from_chars_result parse (const char* first, const char* last, std::vector<T>& c, char& var){
+        c.assign(1, T(0));
+        var = '\0';
+        const char* p = first;
+
+        for (bool first_term = true; ; first_term = false){
+            const char* term = p;
+            bool negative = false;
+
+            if (!first_term){
+                if (p == last || (*p != '+' && *p != '-'))
+                    break;
+                negative = (*p == '-');
+                ++p;
+            }
+
+            // The coefficient, or an implicit 1 before the variable ("x", "-x")
+            T coef(1);
+            const auto res = parse_coefficient(p, last, coef);
+            const bool has_coefficient = (res.ec == std::errc());
+
+            if (has_coefficient)
+                p = res.ptr;
+            else if (res.ec != std::errc::invalid_argument)
+                return {first, res.ec};
+            else if (first_term && p != last && *p == '-' && p+1 != last && is_letter(p[1])){
+                negative = true;
+                ++p;
+            }
+
+            if (!has_coefficient && (p == last || !is_letter(*p))){
+                if (first_term)
+                    return {first, std::errc::invalid_argument};
+                p = term;
+                break;
+            }
+
+            // The variable and its exponent
+            std::size_t e = 0;
+            if (p != last && is_letter(*p)){
+                if (is_exponent_mark(*p))
+                    return {first, std::errc::invalid_argument};
+                if (var != '\0' && var != *p){
+                    p = term;
+                    break;
+                }
+                var = *p++;
+
+                const auto exp = parse_exponent(p, last, e);
+                if (exp.ec != std::errc())
+                    return {first, exp.ec};
+                p = exp.ptr;
+            }
+
+            if (e >= c.size()){
+                if (e > std::max(MAX_EXPONENT, static_cast<std::size_t>(last-first)))
+                    return {first, std::errc::result_out_of_range};
+                c.resize(e+1, T(0));
+            }
+            c[e] += negative ? T(0)-coef : coef;
+        }
+
+        // Stopping before an 'e' means a number took it as its exponent ("2e+3e^2")
+        if (p != last && is_exponent_mark(*p))
+            return {first, std::errc::invalid_argument};
+
+        return {p, std::errc()};
+    }
+}
+
+/* Parses a polynomial in the format operator<< writes (for any variable
+ * letter, with ^n or Unicode superscript exponents, and real or complex
+ * coefficients) from [first, last), like std::from_chars does with numbers:
+ * no whitespace is skipped, parsing stops at the first character that
+ * can't continue the polynomial and, on success, ptr points to it. On
+ * failure pol is left unchanged, ptr is first and ec says why.
+ *
+ * An exponent above both io_aux::MAX_EXPONENT (2^20) and the length of
+ * the input gives std::errc::result_out_of_range.
  *
- * One idea could be to implement a parser, so it would work for std::cin
- * and a new constructor.
+ * Terms may come in any order and repeated exponents add up. A missing
+ * coefficient before the variable is 1 ("x^2-x"), and a constant keeps the
+ * variable of pol. The numbers go through std::from_chars, so the locale
+ * is never used. Since 'e' starts the exponent of a number, the variable
+ * can't be 'e' or 'E': they give std::errc::invalid_argument, wherever
+ * they are (even where a number has already swallowed them as its exponent)
+ */
+template <typename CType>
+std::from_chars_result from_chars (const char* first, const char* last, Polynomial<CType>& pol){
+    thread_local std::vector<CType> c;
+    char var;
+
+    const auto res = io_aux::parse(first, last, c, var);
+    if (res.ec == std::errc()){
+        const char v = (var != '\0') ? var : pol.get_variable();
+        pol = Polynomial<CType>(c.begin(), c.end());
+        pol.set_variable(v);
+    }
+
+    return res;
+}
+
+/* Bulk parser: one polynomial per line of [first, last) (blank lines are
+ * skipped and "\r\n" line ends are accepted), written to out. Returns
+ * {last, errc()} if every line is a polynomial, and otherwise the start of
+ * the first line that isn't, with the error
+ */
+template <typename CType, typename OutputIt>
+std::from_chars_result parse_lines (const char* first, const char* last, OutputIt out){
+    thread_local std::vector<CType> c;
+    char var;
+
+    while (first != last){
+        const char* eol = static_cast<const char*>(std::memchr(first, '\n', static_cast<std::size_t>(last-first)));
+        const char* next = eol ? eol+1 : last;
+        const char* end = eol ? eol : last;
+        while (end != first && io_aux::is_space(end[-1]))
+            --end;
+
+        if (end != first){
+            const auto res = io_aux::parse(first, end, c, var);
+            if (res.ec != std::errc() || res.ptr != end)
+                return {first, (res.ec != std::errc()) ? res.ec : std::errc::invalid_argument};
+
+            Polynomial<CType> pol(c.begin(), c.end());
+            if (var != '\0')
+                pol.set_variable(var);
+            *out++ = std::move(pol);
+        }
+
+        first = next;
+    }
+
+    return {last, std::errc()};
+}
+
+/* Like the previous one, but returning the polynomials. Throws
+ * std::invalid_argument (with the line number) if a line isn't a polynomial
+ */
+template <typename CType>
+std::vector<Polynomial<CType>> parse_lines (std::string_view text){
+    std::vector<Polynomial<CType>> ret;
+    const auto res = parse_lines<CType>(text.data(), text.data()+text.size(), std::back_inserter(ret));
+
+    if (res.ec != std::errc()){
+        const auto line = 1 + std::count(text.data(), res.ptr, '\n');
+        throw std::invalid_argument("fgs::parse_lines: line " + std::to_string(line) + " is not a polynomial");
+    }
+
+    return ret;
+}
+
+/* Reads a polynomial written by operator<< (see fgs::from_chars). Leading
+ * whitespace is skipped and the polynomial ends at the next whitespace. If
+ * it isn't a polynomial, failbit is set and pol is left unchanged
+ */
+template <typename CType, typename traits>
+std::basic_istream<char, traits>&
+operator>> (std::basic_istream<char, traits> &is, Polynomial<CType> &pol){
+    const typename std::basic_istream<char, traits>::sentry ok(is);
+    if (!ok)
+        return is;
+
+    thread_local std::string token;
+    thread_local std::vector<CType> coefficients;
+    token.clear();
+
+    auto *buf = is.rdbuf();
+    auto c = buf->sgetc();
+    for (; !traits::eq_int_type(c, traits::eof()) && !io_aux::is_space(traits::to_char_type(c)); c = buf->snextc())
+        token.push_back(traits::to_char_type(c));
+
+    if (traits::eq_int_type(c, traits::eof()))
+        is.setstate(std::ios_base::eofbit);
+
+    char var;
+    const auto res = io_aux::parse(token.data(), token.data()+token.size(), coefficients, var);
+    if (token.empty() || res.ec != std::errc() || res.ptr != token.data()+token.size()){
+        is.setstate(std::ios_base::failbit);
+        return is;
+    }
+
+    // A constant keeps the variable of pol
+    const char v = (var != '\0') ? var : pol.get_variable();
+    pol = Polynomial<CType>(coefficients.begin(), coefficients.end());
+    pol.set_variable(v);
+
+    return is;
+}
+
+/* Options of the formatter, which mirror the stream flags operator<< uses:
+ * the floating-point format and precision (std::fixed, std::scientific
+ * and std::setprecision), std::showpos and std::uppercase. The default
+ * spec gives the same output as a default-constructed stream
+ */
+struct FormatSpec{
+    std::chars_format format = std::chars_format::general;
+    int precision = 6;
+    bool showpos = false;   // Sign of the independent coefficient even if it's positive
+    bool uppercase = false; // 1E+10, INF, NAN
+};
+
+namespace io_aux{
+    // Coefficient types the formatter writes with std::to_chars
+    template <typename T>
+    inline constexpr bool is_formattable_v =
+        std::is_floating_point_v<detail::reduce_complex_t<T>> ||
+        (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+         !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>);
+
+    // Exponent glyphs, as detail::exponent writes them
+    inline constexpr std::array<std::string_view, 10> SUPERSCRIPT_DIGITS = {
+        "\u2070", "\u00B9", "\u00B2", "\u00B3", "\u2074",
+        "\u2075", "\u2076", "\u2077", "\u2078", "\u2079"
+    };
+
+    // Writes through an output iterator
+    template <typename OutputIt>
+    struct IteratorSink{
+        OutputIt out;
+
+        bool put (const char* first, std::size_t n){
+            out = std::copy(first, first+n, out);
+            return true;
+        }
+    };
+
+    // Writes to [cur, last), failing (without writing) when there isn't room
+    struct BufferSink{
+        char* cur;
+        char* last;
+
+        bool put (const char* first, std::size_t n){
+            if (static_cast<std::size_t>(last-cur) < n)
+                return false;
+            cur = std::copy(first, first+n, cur);
+            return true;
+        }
+    };
+
+    template <typename Sink>
+    bool put (Sink& sink, std::string_view s){
+        return sink.put(s.data(), s.size());
+    }
+
+    /* A real number as printf (and so a stream in the "C" locale) writes
+     * it. Fixed notation of huge values doesn't fit in the stack buffer,
+     * and only then memory is allocated
+     */
+    template <typename Sink, typename T>
+    bool put_number (Sink& sink, T x, const FormatSpec& spec, bool showpos){
+        char stack[128];
+        char* first = stack;
+        std::to_chars_result res;
+        std::vector<char> heap;
+
+        const bool sign = showpos && !std::signbit(static_cast<long double>(x)) &&
+                          (std::is_floating_point_v<T> || std::is_signed_v<T>);
+        if (sign)
+            *first++ = '+';
+
+        if constexpr (std::is_floating_point_v<T>){
+            res = std::to_chars(first, std::end(stack), x, spec.format, spec.precision);
+            if (res.ec != std::errc()){
+                heap.resize(std::numeric_limits<T>::max_exponent10 + static_cast<std::size_t>(spec.precision) + 16);
+                first = heap.data();
+                if (sign)
+                    *first++ = '+';
+                res = std::to_chars(first, heap.data()+heap.size(), x, spec.format, spec.precision);
+            }
+        }
+        else
+            res = std::to_chars(first, std::end(stack), x);
+
+        char* begin = heap.empty() ? stack : heap.data();
+        if (spec.uppercase)
+            for (char* c = begin; c != res.ptr; ++c)
+                if (*c >= 'a' && *c <= 'z')
+                    *c = static_cast<char>(*c - 'a' + 'A');
+
+        return sink.put(begin, static_cast<std::size_t>(res.ptr-begin));
+    }
+
+    // A coefficient as operator<< writes it: (real,imag) for complex types
+    template <typename Sink, typename T>
+    bool put_coefficient (Sink& sink, const T& c, const FormatSpec& spec, bool showpos){
+        if constexpr (detail::is_complex_v<T>)
+            return put(sink, "(") && put_number(sink, c.real(), spec, showpos) && put(sink, ",") &&
+                   put_number(sink, c.imag(), spec, showpos) && put(sink, ")");
+        else
+            return put_number(sink, c, spec, showpos);
+    }
+
+    // The variable and, from 2 on, the exponent (superscripts with UNICODE_SUPPORT)
+    template <typename Sink>
+    bool put_power (Sink& sink, char var, std::size_t i){
+        if (!sink.put(&var, 1))
+            return false;
+        if (i < 2)
+            return true;
+
+        char digits[std::numeric_limits<std::size_t>::digits10 + 2];
+#ifdef UNICODE_SUPPORT
+        std::size_t n = 0;
+        for (; i > 0; i /= 10)
+            digits[n++] = static_cast<char>(i % 10);
+        while (n > 0)
+            if (!put(sink, SUPERSCRIPT_DIGITS[static_cast<std::size_t>(digits[--n])]))
+                return false;
+        return true;
+#else
+        digits[0] = '^';
+        const auto res = std::to_chars(digits+1, std::end(digits), i);
+        return sink.put(digits, static_cast<std::size_t>(res.ptr-digits));
+#endif
+    }
+
+    // The whole polynomial, in the same layout as the stream version
+    template <typename Sink, typename CType>
+    bool format (Sink& sink, const Polynomial<CType>& pol, const FormatSpec& spec){
+        if (pol.degree() == 0)
+            return put_coefficient(sink, pol[0], spec, spec.showpos);
+
+        constexpr bool is_complex = detail::is_complex_v<CType>;
+        if (pol[0] != CType(0) && !put_coefficient(sink, pol[0], spec, spec.showpos))
+            return false;
+
+        for (typename Polynomial<CType>::size_type i=1; i<=pol.degree(); ++i){
+            if (pol[i] == CType(0))
+                continue;
+
+            const bool ok = is_complex
+                ? put(sink, "+") && put_coefficient(sink, pol[i], spec, spec.showpos)
+                : put_coefficient(sink, pol[i], spec, true);
+            if (!ok || !put_power(sink, pol.get_variable(), i))
+                return false;
+        }
+
+        return true;
+    }
+
+    /* The spec that reproduces what os would write, if there is one: the
+     * numbers must be formatted in the "C" locale and only the flags of
+     * FormatSpec can be set (hexfloat, showpoint, showbase or a non-decimal
+     * base are left to the stream). So is std::fixed with std::uppercase,
+     * where only inf and nan could change, and the standard libraries don't
+     * agree on whether they do
+     */
+    template <typename charT, typename traits>
+    bool stream_spec (const std::basic_ostream<charT, traits>& os, FormatSpec& spec){
+        using std::ios_base;
+        const auto flags = os.flags();
+        const auto supported = ios_base::skipws | ios_base::unitbuf | ios_base::boolalpha |
+                               ios_base::adjustfield | ios_base::dec | ios_base::showpos |
+                               ios_base::uppercase | ios_base::floatfield;
+
+        if ((flags & ~supported) || (flags & ios_base::floatfield) == ios_base::floatfield || os.precision() < 0)
+            return false;
+        if ((flags & ios_base::fixed) && (flags & ios_base::uppercase))
+            return false;
+
+        // Numbers are written with the global locale (see stream_format)
+        const auto &punct = std::use_facet<std::numpunct<char>>(std::locale());
+        if (punct.decimal_point() != '.' || !punct.grouping().empty())
+            return false;
+
+        spec.format = (flags & ios_base::fixed) ? std::chars_format::fixed :
+                      (flags & ios_base::scientific) ? std::chars_format::scientific : std::chars_format::general;
+        spec.precision = static_cast<int>(os.precision());
+        spec.showpos = (flags & ios_base::showpos) != 0;
+        spec.uppercase = (flags & ios_base::uppercase) != 0;
+        return true;
+    }
+
+    // Output through a string stream, for the cases the formatter doesn't cover
+    template <typename CType, typename charT, typename traits>
+    std::basic_ostream<charT, traits>&
+    stream_format (std::basic_ostream<charT, traits> &os, const Polynomial<CType> &pol){
+        std::basic_ostringstream<charT, traits> s;
+        s.flags(os.flags());
+        s.precision(os.precision());
+
+        if (pol.degree() == 0)
+            s << pol[0];
+        else{
+            if constexpr (detail::is_complex_v<CType>){
+                if (pol[0] != CType(0))
+                    s << pol[0];
+                if (pol[1] != CType(0))
+                    s << "+" << pol[1] << pol.get_variable();
+
+                for (typename Polynomial<CType>::size_type i=2; i<=pol.degree(); ++i)
+                    if (pol[i] != CType(0))
+                        s << "+" << pol[i] << pol.get_variable() << detail::exponent(i);
+            }
+            else{
+                if (pol[0] != CType(0))
+                    s << pol[0];
+                s << std::showpos;
+                if (pol[1] != CType(0))
+                    s << pol[1] << pol.get_variable();
+
+                for (typename Polynomial<CType>::size_type i=2; i<=pol.degree(); ++i)
+                    if (pol[i] != CType(0))
+                        s << pol[i] << pol.get_variable() << detail::exponent(i);
+            }
+        }
+
+        return os << s.str();
+    }
+}
+
+/* Writes pol to [first, last) in the format of operator<<, with
+ * std::to_chars and without allocating, like std::to_chars does with
+ * numbers: on success ptr is one past the last character written, and if
+ * the buffer is too small ec is std::errc::value_too_large and ptr is last
  */
-// std::istream& operator>>(std::istream& is, Polynomial& pol);
+template <typename CType>
+std::to_chars_result to_chars (char* first, char* last, const Polynomial<CType>& pol, const FormatSpec& spec = {}){
+    static_assert(io_aux::is_formattable_v<CType>, "Coefficient type not supported by the formatter");
+
+    io_aux::BufferSink sink{first, last};
+    if (!io_aux::format(sink, pol, spec))
+        return {last, std::errc::value_too_large};
+    return {sink.cur, std::errc()};
+}
+
+// Writes pol through the output iterator out, as to_chars. Returns the iterator past the output
+template <typename OutputIt, typename CType>
+OutputIt format_to (OutputIt out, const Polynomial<CType>& pol, const FormatSpec& spec = {}){
+    static_assert(io_aux::is_formattable_v<CType>, "Coefficient type not supported by the formatter");
+
+    io_aux::IteratorSink<OutputIt> sink{out};
+    io_aux::format(sink, pol, spec);
+    return sink.out;
+}
 
 /* Pretty print for the polynomial
  *
  * If UNICODE_SUPPORT is enabled, the polynomial will be printed
- * with superscript characters instead of the expresion "^n"
+ * with superscript characters instead of the expresion "^n".
+ *
+ * Floating-point and integer coefficients go through the formatter above
+ * (into a per-thread buffer, so nothing is allocated once it has grown)
+ * whenever it writes exactly what the stream would; any other type, flag
+ * or locale goes through a string stream
  */
 template <typename CType, typename charT, typename traits>
 std::basic_ostream<charT, traits>&
 operator<< (std::basic_ostream<charT, traits> &os, const Polynomial<CType> &pol){
-    std::basic_ostringstream<charT, traits> s;
-    s.flags(os.flags());
-    s.precision(os.precision());
-
-    if (pol.degree() == 0)
-        s << pol[0];
-    else{
-        if constexpr (detail::is_complex_v<CType>){
-            if (pol[0] != CType(0))
-                s << pol[0];
-            if (pol[1] != CType(0))
-                s << "+" << pol[1] << pol.get_variable();
-
-            for (typename Polynomial<CType>::size_type i=2; i<=pol.degree(); ++i)
-                if (pol[i] != CType(0))
-                    s << "+" << pol[i] << pol.get_variable() << detail::exponent(i);
-        }
-        else{
-            if (pol[0] != CType(0))
-                s << pol[0];
-            s << std::showpos;
-            if (pol[1] != CType(0))
-                s << pol[1] << pol.get_variable();
-
-            for (typename Polynomial<CType>::size_type i=2; i<=pol.degree(); ++i)
-                if (pol[i] != CType(0))
-                    s << pol[i] << pol.get_variable() << detail::exponent(i);
+    if constexpr (std::is_same_v<charT, char> && io_aux::is_formattable_v<CType>){
+        FormatSpec spec;
+        if (io_aux::stream_spec(os, spec)){
+            thread_local std::string buffer;
+            buffer.clear();
+            format_to(std::back_inserter(buffer), pol, spec);
+            return os << std::string_view(buffer);
         }
     }
 
-    return os << s.str();
+    return io_aux::stream_format(os, pol);
 }
 
 }   // namespace fgs
+
+#ifdef __cpp_lib_format
+/* std::format support: {:[+][.precision][e|E|f|F|g|G]}, with the meaning
+ * of the printf conversions ({} writes what operator<< writes by default)
+ */
+template <typename CType>
+struct std::formatter<fgs::Polynomial<CType>, char>{
+    fgs::FormatSpec spec;
+
+    constexpr auto parse (std::format_parse_context& ctx){
+        auto it = ctx.begin();
+        const auto end = ctx.end();
+
+        if (it != end && *it == '+'){
+            spec.showpos = true;
+            ++it;
+        }
+        if (it != end && *it == '.'){
+            spec.precision = 0;
+            for (++it; it != end && *it >= '0' && *it <= '9'; ++it)
+                spec.precision = 10*spec.precision + (*it - '0');
+        }
+        if (it != end && *it != '}'){
+            switch (*it){
+                case 'E': spec.uppercase = true; [[fallthrough]];
+                case 'e': spec.format = std::chars_format::scientific; break;
+                case 'F': spec.uppercase = true; [[fallthrough]];
+                case 'f': spec.format = std::chars_format::fixed; break;
+                case 'G': spec.uppercase = true; [[fallthrough]];
+                case 'g': spec.format = std::chars_format::general; break;
+                default: throw std::format_error("fgs::Polynomial: invalid format specifier");
+            }
+            ++it;
+        }
+        if (it != end && *it != '}')
+            throw std::format_error("fgs::Polynomial: invalid format specifier");
+
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format (const fgs::Polynomial<CType>& pol, FormatContext& ctx) const{
+        return fgs::format_to(ctx.out(), pol, spec);
+    }
+};
+#endif
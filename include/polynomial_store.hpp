@@ -0,0 +1,471 @@
+#pragma once
+
+#include "detail.hpp"
+#include "polynomial.hpp"
+#include "polynomial_batch.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::min
+#include <array>        // std::array
+#include <complex>      // std::complex
+#include <cstddef>      // std::size_t, std::max_align_t
+#include <cstdint>      // std::uint8_t, std::uint16_t, std::uint64_t
+#include <cstring>      // std::memcpy, std::memcmp
+#include <fstream>      // std::ifstream, std::ofstream
+#include <istream>      // std::istream
+#include <memory>       // std::unique_ptr
+#include <ostream>      // std::ostream
+#include <stdexcept>    // std::runtime_error, std::out_of_range
+#include <string>       // std::string
+#include <type_traits>  // std::is_same_v, std::is_integral_v, std::is_signed_v
+#include <utility>      // std::exchange, std::move, std::swap
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FGS_STORE_MMAP
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close
+#endif
+
+/* Binary serialization of polynomials
+ *
+ * A single polynomial is written as a 32-byte header followed by its
+ * coefficients, lowest degree first, as raw little-endian values:
+ *
+ *   offset  size  field
+ *        0     4  magic "FGSP"
+ *        4     2  format version (FORMAT_VERSION)
+ *        6     1  coefficient type tag (see store_aux::type_tag)
+ *        7     1  size in bytes of a real coefficient (or of a real part)
+ *        8     1  variable
+ *        9    15  reserved (zero)
+ *       24     8  number of coefficients (degree+1)
+ *
+ * A store holds many polynomials of the same type in one file: a 32-byte
+ * header, the coefficients of every polynomial (each block aligned to 16
+ * bytes) and, at the end, an index with one 24-byte entry per polynomial:
+ *
+ *   header: magic "FGSS", version (2), tag (1), size (1), number of
+ *           polynomials (8), offset of the index (8), reserved (8)
+ *   entry:  offset of the coefficients (8), number of coefficients (8),
+ *           variable (1), reserved (7)
+ *
+ * PolynomialStore maps the file into memory and hands out views of the
+ * coefficients where they are (PolynomialView, see polynomial_batch.hpp),
+ * so opening a store doesn't read or copy any coefficient.
+ *
+ * long double is stored as it is in memory, so it can only be read back on
+ * the same kind of platform (the size byte catches most mismatches)
+ */
+namespace fgs{
+
+namespace store_aux{
+    inline static constexpr std::uint16_t FORMAT_VERSION = 1;
+    inline static constexpr std::size_t HEADER_SIZE = 32;
+    inline static constexpr std::size_t ENTRY_SIZE = 24;
+    inline static constexpr std::size_t ALIGNMENT = 16;
+    inline static constexpr std::size_t READ_CHUNK = std::size_t(1) << 16;     // Coefficients read at once
+
+    inline static constexpr std::array<char, 4> POLYNOMIAL_MAGIC = {'F', 'G', 'S', 'P'};
+    inline static constexpr std::array<char, 4> STORE_MAGIC = {'F', 'G', 'S', 'S'};
+
+    /* Tag of each coefficient type the format supports (0 for the rest):
+     * the floating-point types, their complex versions and the signed
+     * integers
+     */
+    template <typename T>
+    constexpr std::uint8_t type_tag (){
+        using Real = detail::reduce_complex_t<T>;
+        constexpr std::uint8_t complex_offset = detail::is_complex_v<T> ? 3 : 0;
+
+        if constexpr (std::is_same_v<Real, float>)
+            return 1 + complex_offset;
+        else if constexpr (std::is_same_v<Real, double>)
+            return 2 + complex_offset;
+        else if constexpr (std::is_same_v<Real, long double>)
+            return 3 + complex_offset;
+        else if constexpr (detail::is_complex_v<T>)
+            return 0;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= 8)
+            return 7 + (sizeof(T) >= 2) + (sizeof(T) >= 4) + (sizeof(T) >= 8);
+        else
+            return 0;
+    }
+
+    template <typename T>
+    inline constexpr bool is_storable_v = type_tag<T>() != 0;
+
+    // Size of the values that are byte-swapped: the real parts of complex types
+    template <typename T>
+    inline constexpr std::size_t word_size_v = sizeof(detail::reduce_complex_t<T>);
+
+    inline bool is_little_endian (){
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+        return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+#else
+        const std::uint16_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+#endif
+    }
+
+    // Reverses the bytes of each word of width bytes in [data, data+n)
+    inline void swap_words (char* data, std::size_t n, std::size_t width){
+        for (std::size_t i=0; i+width<=n; i+=width)
+            for (std::size_t a=i, b=i+width-1; a<b; ++a, --b)
+                std::swap(data[a], data[b]);
+    }
+
+    // Little-endian encoding of unsigned integers in a header
+    template <typename UInt>
+    void put (char* out, UInt x){
+        for (std::size_t i=0; i<sizeof(UInt); ++i, x = static_cast<UInt>(x >> 8))
+            out[i] = static_cast<char>(x & 0xFF);
+    }
+
+    template <typename UInt>
+    UInt get (const char* in){
+        UInt x = 0;
+        for (std::size_t i=sizeof(UInt); i>0; --i)
+            x = static_cast<UInt>((x << 8) | static_cast<unsigned char>(in[i-1]));
+        return x;
+    }
+
+    inline std::uint64_t align (std::uint64_t offset){
+        return (offset + ALIGNMENT-1)/ALIGNMENT*ALIGNMENT;
+    }
+
+    template <typename T>
+    std::array<char, HEADER_SIZE> header (const std::array<char, 4>& magic){
+        std::array<char, HEADER_SIZE> ret{};
+        std::memcpy(ret.data(), magic.data(), magic.size());
+        put<std::uint16_t>(ret.data()+4, FORMAT_VERSION);
+        put<std::uint8_t>(ret.data()+6, type_tag<T>());
+        put<std::uint8_t>(ret.data()+7, static_cast<std::uint8_t>(word_size_v<T>));
+        return ret;
+    }
+
+    // Throws std::runtime_error if h is not a header of the given kind for T
+    template <typename T>
+    void check_header (const char* h, const std::array<char, 4>& magic){
+        if (std::memcmp(h, magic.data(), magic.size()) != 0)
+            throw std::runtime_error("fgs: not a polynomial file");
+        if (get<std::uint16_t>(h+4) > FORMAT_VERSION)
+            throw std::runtime_error("fgs: unsupported format version");
+        if (get<std::uint8_t>(h+6) != type_tag<T>() || get<std::uint8_t>(h+7) != word_size_v<T>)
+            throw std::runtime_error("fgs: the file holds another coefficient type");
+    }
+
+    // Writes n coefficients as little-endian values
+    template <typename T>
+    void write_coefficients (std::ostream& os, const T* data, std::size_t n){
+        if (is_little_endian()){
+            os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n*sizeof(T)));
+            return;
+        }
+
+        std::vector<T> copy(data, data+n);
+        swap_words(reinterpret_cast<char*>(copy.data()), n*sizeof(T), word_size_v<T>);
+        os.write(reinterpret_cast<const char*>(copy.data()), static_cast<std::streamsize>(n*sizeof(T)));
+    }
+
+    inline void pad (std::ostream& os, std::uint64_t from, std::uint64_t to){
+        static constexpr std::array<char, ALIGNMENT> zeros{};
+        os.write(zeros.data(), static_cast<std::streamsize>(to-from));
+    }
+}
+
+/* Writes pol in the binary format above. T must be storable (a
+ * floating-point type, its complex version or a signed integer)
+ */
+template <typename CType>
+std::ostream& write_binary (std::ostream& os, const Polynomial<CType>& pol){
+    static_assert(store_aux::is_storable_v<CType>, "Coefficient type not supported by the binary format");
+
+    auto h = store_aux::header<CType>(store_aux::POLYNOMIAL_MAGIC);
+    h[8] = pol.get_variable();
+    store_aux::put<std::uint64_t>(h.data()+24, pol.degree()+1);
+    os.write(h.data(), h.size());
+
+    const std::vector<CType> c(pol.begin(), pol.end());
+    store_aux::write_coefficients(os, c.data(), c.size());
+    return os;
+}
+
+/* Reads a polynomial written by write_binary. Throws std::runtime_error if
+ * the data is not a polynomial of type CType or it is truncated.
+ *
+ * The number of coefficients comes from the data, so it isn't trusted: if
+ * the stream can seek, a count larger than what is left in it is rejected
+ * before allocating, and otherwise the coefficients are read in chunks, so
+ * the memory never runs much ahead of the data actually there
+ */
+template <typename CType>
+Polynomial<CType> read_binary (std::istream& is){
+    static_assert(store_aux::is_storable_v<CType>, "Coefficient type not supported by the binary format");
+
+    std::array<char, store_aux::HEADER_SIZE> h;
+    if (!is.read(h.data(), h.size()))
+        throw std::runtime_error("fgs::read_binary: truncated header");
+    store_aux::check_header<CType>(h.data(), store_aux::POLYNOMIAL_MAGIC);
+
+    const auto n = store_aux::get<std::uint64_t>(h.data()+24);
+    if (n == 0)
+        throw std::runtime_error("fgs::read_binary: polynomial without coefficients");
+
+    if (const auto here = is.tellg(); here != std::streampos(-1)){
+        is.seekg(0, std::ios::end);
+        const auto end = is.tellg();
+        is.seekg(here);
+        if (end != std::streampos(-1) && n > static_cast<std::uint64_t>(end - here)/sizeof(CType))
+            throw std::runtime_error("fgs::read_binary: truncated coefficients");
+    }
+
+    std::vector<CType> c;
+    for (std::uint64_t done=0; done<n;){
+        const auto chunk = std::min<std::uint64_t>(n-done, store_aux::READ_CHUNK);
+        c.resize(static_cast<std::size_t>(done+chunk));
+        if (!is.read(reinterpret_cast<char*>(c.data()+done), static_cast<std::streamsize>(chunk*sizeof(CType))))
+            throw std::runtime_error("fgs::read_binary: truncated coefficients");
+        done += chunk;
+    }
+    if (!store_aux::is_little_endian())
+        store_aux::swap_words(reinterpret_cast<char*>(c.data()), n*sizeof(CType), store_aux::word_size_v<CType>);
+
+    Polynomial<CType> ret(c.begin(), c.end());
+    ret.set_variable(h[8]);
+    return ret;
+}
+
+/* Class StoreWriter. Writes a store file one polynomial at a time, so
+ * sets larger than memory can be written. The index is written by close()
+ * (or by the destructor, which can't report errors)
+ */
+template <typename CType>
+class StoreWriter{
+    static_assert(store_aux::is_storable_v<CType>, "Coefficient type not supported by the binary format");
+
+public:
+    explicit StoreWriter (const std::string& path)
+        : file(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!file)
+            throw std::runtime_error("fgs::StoreWriter: can't open " + path);
+
+        const auto h = store_aux::header<CType>(store_aux::STORE_MAGIC);
+        file.write(h.data(), h.size());
+    }
+
+    StoreWriter (const StoreWriter&) = delete;
+    StoreWriter& operator= (const StoreWriter&) = delete;
+
+    ~StoreWriter (){
+        try{
+            if (file.is_open())
+                close();
+        }
+        catch (...) {}
+    }
+
+    template <typename CType2>
+    StoreWriter& append (const Polynomial<CType2>& pol){
+        const std::vector<CType> c(pol.begin(), pol.end());
+
+        std::array<char, store_aux::ENTRY_SIZE> entry{};
+        store_aux::put<std::uint64_t>(entry.data(), offset);
+        store_aux::put<std::uint64_t>(entry.data()+8, c.size());
+        entry[16] = pol.get_variable();
+        index.insert(index.end(), entry.begin(), entry.end());
+
+        store_aux::write_coefficients(file, c.data(), c.size());
+        const auto next = store_aux::align(offset + c.size()*sizeof(CType));
+        store_aux::pad(file, offset + c.size()*sizeof(CType), next);
+        offset = next;
+
+        return *this;
+    }
+
+    // Number of polynomials appended so far
+    std::size_t size () const noexcept{ return index.size()/store_aux::ENTRY_SIZE; }
+
+    // Writes the index and the final header. Throws std::runtime_error if anything failed
+    void close (){
+        file.write(index.data(), static_cast<std::streamsize>(index.size()));
+
+        auto h = store_aux::header<CType>(store_aux::STORE_MAGIC);
+        store_aux::put<std::uint64_t>(h.data()+8, size());
+        store_aux::put<std::uint64_t>(h.data()+16, offset);
+        file.seekp(0);
+        file.write(h.data(), h.size());
+
+        const bool ok = static_cast<bool>(file);
+        file.close();
+        if (!ok)
+            throw std::runtime_error("fgs::StoreWriter: write error");
+    }
+
+private:
+    std::ofstream file;
+    std::vector<char> index;                            // Entries of the polynomials appended
+    std::uint64_t offset = store_aux::HEADER_SIZE;      // Where the next coefficients go
+};
+
+// Writes the polynomials of [first, last) as a store file
+template <typename CType, typename InputIt>
+void write_store (const std::string& path, InputIt first, InputIt last){
+    StoreWriter<CType> writer(path);
+    for (; first != last; ++first)
+        writer.append(*first);
+    writer.close();
+}
+
+/* Class PolynomialStore. Read-only access to a store file, mapped into
+ * memory (on POSIX systems; elsewhere the file is read into a buffer).
+ * Polynomials are handed out as views of the mapped coefficients, which
+ * stay valid while the store is alive.
+ *
+ * The constructor only validates the header and the index. Throws
+ * std::runtime_error if the file can't be opened or is not a well-formed
+ * store of CType. Views need a little-endian host
+ */
+template <typename CType>
+class PolynomialStore{
+    static_assert(store_aux::is_storable_v<CType>, "Coefficient type not supported by the binary format");
+
+public:
+    using value_type    = CType;
+    using size_type     = std::size_t;
+    using const_view    = PolynomialView<CType, true>;
+
+    explicit PolynomialStore (const std::string& path){
+        if (!store_aux::is_little_endian())
+            throw std::runtime_error("fgs::PolynomialStore: zero-copy views need a little-endian host");
+
+        open(path);
+        try{
+            validate();
+        }
+        catch (...){
+            release();
+            throw;
+        }
+    }
+
+    PolynomialStore (PolynomialStore&& other) noexcept
+        : data(std::exchange(other.data, nullptr)), length(std::exchange(other.length, 0)),
+          buffer(std::move(other.buffer)), count(std::exchange(other.count, 0)),
+          index(std::exchange(other.index, nullptr)) {}
+
+    PolynomialStore& operator= (PolynomialStore&& other) noexcept{
+        if (this != &other){
+            release();
+            data = std::exchange(other.data, nullptr);
+            length = std::exchange(other.length, 0);
+            buffer = std::move(other.buffer);
+            count = std::exchange(other.count, 0);
+            index = std::exchange(other.index, nullptr);
+        }
+        return *this;
+    }
+
+    PolynomialStore (const PolynomialStore&) = delete;
+    PolynomialStore& operator= (const PolynomialStore&) = delete;
+
+    ~PolynomialStore (){ release(); }
+
+    size_type size () const noexcept{ return count; }
+    bool empty () const noexcept{ return count == 0; }
+
+    const_view operator[] (size_type i) const{
+        const char* entry = index + i*store_aux::ENTRY_SIZE;
+        return const_view(reinterpret_cast<const CType*>(data + store_aux::get<std::uint64_t>(entry)), 1,
+                          store_aux::get<std::uint64_t>(entry+8), entry[16]);
+    }
+
+    const_view at (size_type i) const{
+        if (i >= count)
+            throw std::out_of_range("fgs::PolynomialStore::at: polynomial out of range");
+        return (*this)[i];
+    }
+
+private:
+    const char* data = nullptr;         // The whole file
+    std::size_t length = 0;
+    std::unique_ptr<std::max_align_t[]> buffer;     // Holds the file when it isn't mapped
+    size_type count = 0;                // Number of polynomials
+    const char* index = nullptr;        // First entry of the index
+
+    void open (const std::string& path){
+#ifdef FGS_STORE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("fgs::PolynomialStore: can't open " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0){
+            ::close(fd);
+            throw std::runtime_error("fgs::PolynomialStore: can't read " + path);
+        }
+
+        length = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("fgs::PolynomialStore: can't map " + path);
+
+        data = static_cast<const char*>(p);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("fgs::PolynomialStore: can't open " + path);
+
+        length = static_cast<std::size_t>(file.tellg());
+        buffer.reset(new std::max_align_t[(length + sizeof(std::max_align_t)-1)/sizeof(std::max_align_t)]);
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(length)))
+            throw std::runtime_error("fgs::PolynomialStore: can't read " + path);
+
+        data = reinterpret_cast<const char*>(buffer.get());
+#endif
+    }
+
+    void release () noexcept{
+#ifdef FGS_STORE_MMAP
+        if (data)
+            ::munmap(const_cast<char*>(data), length);
+#endif
+        buffer.reset();
+        data = nullptr;
+        length = 0;
+    }
+
+    // Checks that every polynomial of the index lies inside the file, between the header and the index
+    void validate (){
+        if (length < store_aux::HEADER_SIZE)
+            throw std::runtime_error("fgs::PolynomialStore: truncated header");
+        store_aux::check_header<CType>(data, store_aux::STORE_MAGIC);
+
+        const auto n = store_aux::get<std::uint64_t>(data+8);
+        const auto index_offset = store_aux::get<std::uint64_t>(data+16);
+        if (index_offset > length || n > (length - index_offset)/store_aux::ENTRY_SIZE)
+            throw std::runtime_error("fgs::PolynomialStore: truncated index");
+
+        count = n;
+        index = data + index_offset;
+
+        for (size_type i=0; i<count; ++i){
+            const char* entry = index + i*store_aux::ENTRY_SIZE;
+            const auto offset = store_aux::get<std::uint64_t>(entry);
+            const auto coefficients = store_aux::get<std::uint64_t>(entry+8);
+
+            if (offset % alignof(CType) != 0 || coefficients == 0 ||
+                    offset < store_aux::HEADER_SIZE || offset > index_offset ||
+                    coefficients > (index_offset - offset)/sizeof(CType))
+                throw std::runtime_error("fgs::PolynomialStore: corrupted index");
+        }
+    }
+};
+
+}  // namespace fgs
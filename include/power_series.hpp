@@ -0,0 +1,204 @@
+#pragma once
+
+#include "detail.hpp"
+#include "convolution.hpp"
+#include "polynomial.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::min
+#include <complex>      // std::log, std::exp, std::sqrt for complex coefficients
+#include <cmath>        // std::log, std::exp, std::sqrt
+#include <cstddef>      // std::size_t
+#include <type_traits>  // std::is_floating_point_v, std::common_type_t
+
+/* Truncated power series on top of Polynomial
+ *
+ * Every function works modulo x^n: only the n lowest coefficients of the
+ * result are computed. The Newton iterations cost a constant number of
+ * truncated products each, so everything is O(M(n)), where M(n) is the cost
+ * of a product (see convolution_aux::convolve)
+ */
+namespace fgs::series_aux{
+    template <typename T>
+    inline constexpr bool is_floating_v = std::is_floating_point_v<detail::reduce_complex_t<T>>;
+
+    template <typename CType>
+    std::vector<CType> coefficients (const Polynomial<CType>& p, std::size_t n){
+        std::vector<CType> c(p.begin(), p.begin() + std::min<std::size_t>(p.degree()+1, n));
+        c.resize(n, CType(0));
+        return c;
+    }
+
+    template <typename CType>
+    Polynomial<CType> make_series (const std::vector<CType>& c, char var){
+        Polynomial<CType> ret = c.empty() ? Polynomial<CType>() : Polynomial<CType>(c.begin(), c.end());
+        ret.set_variable(var);
+        return ret;
+    }
+
+    // x^k by binary exponentiation
+    template <typename T>
+    T power (T x, unsigned long k){
+        T ret(1);
+
+        for (; k > 0; k >>= 1){
+            if (k & 1)
+                ret *= x;
+            x *= x;
+        }
+
+        return ret;
+    }
+
+    /* log(a) mod x^n. Floating-point coefficients accept any a[0] != 0,
+     * other types need a[0] == 1
+     */
+    template <typename T>
+    std::vector<T> log (const std::vector<T>& a, std::size_t n){
+        std::vector<T> ret(n, T(0));
+        if (n == 0)
+            return ret;
+
+        // log(a) = integral of a'/a
+        std::vector<T> da(n-1, T(0));
+        for (std::size_t i=1; i<std::min(a.size(), n); ++i)
+            da[i-1] = a[i]*T(i);
+
+        const auto q = convolution_aux::convolve_trunc(da, convolution_aux::inverse_trunc(a, n-1), n-1);
+        for (std::size_t i=1; i<n; ++i)
+            ret[i] = q[i-1]/T(i);
+
+        if constexpr (is_floating_v<T>)
+            ret[0] = std::log(a[0]);
+
+        return ret;
+    }
+
+    /* exp(a) mod x^n by Newton's iteration g <- g*(1 + a - log(g)).
+     * Floating-point coefficients accept any a[0], other types need a[0] == 0
+     */
+    template <typename T>
+    std::vector<T> exp (const std::vector<T>& a, std::size_t n){
+        if (n == 0)
+            return {};
+
+        std::vector<T> g{T(1)};
+        if constexpr (is_floating_v<T>)
+            g[0] = std::exp(a[0]);
+
+        for (std::size_t k=1; k<n;){
+            k = std::min(2*k, n);
+
+            auto e = log(g, k);
+            for (std::size_t i=0; i<k; ++i)
+                e[i] = (i < a.size() ? a[i] : T(0)) - e[i];
+            e[0] += T(1);
+
+            g.resize(k, T(0));
+            g = convolution_aux::convolve_trunc(g, e, k);
+        }
+
+        return g;
+    }
+
+    /* sqrt(a) mod x^n by Newton's iteration g <- (g + a/g)/2.
+     * Floating-point coefficients accept any a[0] != 0, other types need
+     * a[0] == 1
+     */
+    template <typename T>
+    std::vector<T> sqrt (const std::vector<T>& a, std::size_t n){
+        if (n == 0)
+            return {};
+
+        std::vector<T> g{T(1)};
+        if constexpr (is_floating_v<T>)
+            g[0] = std::sqrt(a[0]);
+
+        const T half = T(1)/T(2);
+        for (std::size_t k=1; k<n;){
+            k = std::min(2*k, n);
+
+            const auto q = convolution_aux::convolve_trunc(a, convolution_aux::inverse_trunc(g, k), k);
+            g.resize(k, T(0));
+            for (std::size_t i=0; i<k; ++i)
+                g[i] = (g[i] + q[i])*half;
+        }
+
+        return g;
+    }
+}  // namespace fgs::series_aux
+
+namespace fgs::series{
+    // Low n coefficients of a*b, without computing the high part of the product
+    template <typename CType1, typename CType2>
+    auto mul_trunc (const Polynomial<CType1>& a, const Polynomial<CType2>& b, std::size_t n){
+        using CommonType = std::common_type_t<CType1, CType2>;
+
+        return series_aux::make_series(convolution_aux::convolve_trunc(
+            series_aux::coefficients(Polynomial<CommonType>(a), n),
+            series_aux::coefficients(Polynomial<CommonType>(b), n), n), a.get_variable());
+    }
+
+    // 1/a mod x^n (a[0] must be invertible)
+    template <typename CType>
+    Polynomial<CType> inverse (const Polynomial<CType>& a, std::size_t n){
+        return series_aux::make_series(
+            convolution_aux::inverse_trunc(series_aux::coefficients(a, n), n), a.get_variable());
+    }
+
+    /* log(a) mod x^n. a[0] must be 1 (floating-point coefficients accept
+     * any a[0] != 0, using the principal logarithm for the constant term)
+     */
+    template <typename CType>
+    Polynomial<CType> log (const Polynomial<CType>& a, std::size_t n){
+        return series_aux::make_series(series_aux::log(series_aux::coefficients(a, n), n), a.get_variable());
+    }
+
+    // exp(a) mod x^n. a[0] must be 0 (floating-point coefficients accept any a[0])
+    template <typename CType>
+    Polynomial<CType> exp (const Polynomial<CType>& a, std::size_t n){
+        return series_aux::make_series(series_aux::exp(series_aux::coefficients(a, n), n), a.get_variable());
+    }
+
+    /* sqrt(a) mod x^n. a[0] must be 1 (floating-point coefficients accept
+     * any a[0] != 0, using the principal square root for the constant term)
+     */
+    template <typename CType>
+    Polynomial<CType> sqrt (const Polynomial<CType>& a, std::size_t n){
+        return series_aux::make_series(series_aux::sqrt(series_aux::coefficients(a, n), n), a.get_variable());
+    }
+
+    /* a^k mod x^n, computed as exp(k*log(a)) once the lowest non-zero term
+     * of a is factored out, so a[0] may be 0
+     */
+    template <typename CType>
+    Polynomial<CType> pow (const Polynomial<CType>& a, unsigned long k, std::size_t n){
+        std::vector<CType> ret(n, CType(0));
+
+        std::size_t v = 0;
+        while (v <= a.degree() && a[v] == CType(0))
+            ++v;
+
+        if (k == 0 && n > 0)
+            ret[0] = CType(1);
+        else if (v <= a.degree() && (v == 0 || k < (n + v - 1)/v)){
+            const std::size_t m = n - v*k;
+            const CType lead = a[v];
+
+            std::vector<CType> b(m, CType(0));
+            for (std::size_t i=0; i<m && v+i<=a.degree(); ++i)
+                b[i] = a[v+i]/lead;
+
+            auto l = series_aux::log(b, m);
+            for (auto &elem : l)
+                elem *= CType(k);
+
+            const auto e = series_aux::exp(l, m);
+            const CType factor = series_aux::power(lead, k);
+            for (std::size_t i=0; i<m; ++i)
+                ret[v*k+i] = e[i]*factor;
+        }
+
+        return series_aux::make_series(ret, a.get_variable());
+    }
+}  // namespace fgs::series
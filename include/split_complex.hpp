@@ -0,0 +1,132 @@
+#pragma once
+
+#include "convolution.hpp"
+
+#include <vector>       // std::vector
+#include <algorithm>    // std::min
+#include <complex>      // std::complex
+#include <cstddef>      // std::size_t
+
+/* Kernels for complex coefficients stored as two separate arrays (real and
+ * imaginary parts), lowest degree first.
+ *
+ * std::complex products carry the C99 Annex G NaN/Inf recovery (a library
+ * call for each long double product unless -ffast-math is used), which
+ * also keeps the compiler from vectorizing loops over them. Here complex
+ * arithmetic is spelled out on the real parts, so every loop over
+ * coefficients or points is a plain loop of real multiply-adds
+ */
+namespace fgs::split_aux{
+    /* (ar + i*ai)*(br + i*bi), with no special handling of infinities. The
+     * operands are taken by value, so the result may overwrite them
+     */
+    template <typename Real>
+    inline void multiply (Real ar, Real ai, Real br, Real bi, Real& cr, Real& ci){
+        cr = ar*br - ai*bi;
+        ci = ar*bi + ai*br;
+    }
+
+    // (ar + i*ai)/(br + i*bi), with no special handling of infinities
+    template <typename Real>
+    inline void divide (Real ar, Real ai, Real br, Real bi, Real& cr, Real& ci){
+        const Real norm = br*br + bi*bi;
+        cr = (ar*br + ai*bi)/norm;
+        ci = (ai*br - ar*bi)/norm;
+    }
+
+    // Horner's evaluation of the polynomial (re, im) at xr + i*xi
+    template <typename Real>
+    void horner (const std::vector<Real>& re, const std::vector<Real>& im, Real xr, Real xi, Real& yr, Real& yi){
+        Real sr = re.back(), si = im.back();
+
+        for (std::size_t k=re.size()-1; k>0; --k){
+            const Real tr = sr*xr - si*xi + re[k-1];
+            si = sr*xi + si*xr + im[k-1];
+            sr = tr;
+        }
+
+        yr = sr;
+        yi = si;
+    }
+
+    /* Horner's evaluation at many points (xr[j] + i*xi[j]) at once. The
+     * inner loop runs over the points, so it vectorizes
+     */
+    template <typename Real>
+    void horner (const std::vector<Real>& re, const std::vector<Real>& im,
+                 const std::vector<Real>& xr, const std::vector<Real>& xi,
+                 std::vector<Real>& yr, std::vector<Real>& yi){
+        const std::size_t m = xr.size();
+        yr.assign(m, re.back());
+        yi.assign(m, im.back());
+
+        for (std::size_t k=re.size()-1; k>0; --k){
+            const Real cr = re[k-1], ci = im[k-1];
+
+            for (std::size_t j=0; j<m; ++j){
+                const Real tr = yr[j]*xr[j] - yi[j]*xi[j] + cr;
+                yi[j] = yr[j]*xi[j] + yi[j]*xr[j] + ci;
+                yr[j] = tr;
+            }
+        }
+    }
+
+    /* Product of (ar, ai) and (br, bi) into (cr, ci). Large operands go
+     * through the FFT, small ones through a schoolbook whose inner loop is
+     * four independent real multiply-adds per coefficient
+     */
+    template <typename Real>
+    void convolve (const std::vector<Real>& ar, const std::vector<Real>& ai,
+                   const std::vector<Real>& br, const std::vector<Real>& bi,
+                   std::vector<Real>& cr, std::vector<Real>& ci){
+        const std::size_t n = ar.size()+br.size()-1;
+
+        if (std::min(ar.size(), br.size()) >= tuning::threshold<std::complex<Real>>(tuning::Threshold::fft)){
+            std::vector<std::complex<Real>> a(ar.size()), b(br.size());
+            for (std::size_t i=0; i<a.size(); ++i)
+                a[i] = std::complex<Real>(ar[i], ai[i]);
+            for (std::size_t i=0; i<b.size(); ++i)
+                b[i] = std::complex<Real>(br[i], bi[i]);
+
+            const auto c = convolution_aux::fft_multiply(a, b);
+            cr.resize(n);
+            ci.resize(n);
+            for (std::size_t i=0; i<n; ++i){
+                cr[i] = c[i].real();
+                ci[i] = c[i].imag();
+            }
+            return;
+        }
+
+        cr.assign(n, Real(0));
+        ci.assign(n, Real(0));
+
+        for (std::size_t i=0; i<ar.size(); ++i){
+            const Real xr = ar[i], xi = ai[i];
+            Real* __restrict pr = cr.data() + i;
+            Real* __restrict pi = ci.data() + i;
+
+            for (std::size_t j=0; j<br.size(); ++j){
+                pr[j] += xr*br[j] - xi*bi[j];
+                pi[j] += xr*bi[j] + xi*br[j];
+            }
+        }
+    }
+
+    // Derivative of the polynomial (re, im), in place
+    template <typename Real>
+    void differentiate (std::vector<Real>& re, std::vector<Real>& im){
+        if (re.size() == 1){
+            re[0] = im[0] = Real(0);
+            return;
+        }
+
+        for (std::size_t k=1; k<re.size(); ++k){
+            re[k-1] = re[k]*static_cast<Real>(k);
+            im[k-1] = im[k]*static_cast<Real>(k);
+        }
+
+        re.pop_back();
+        im.pop_back();
+    }
+}  // namespace fgs::split_aux
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "polynomial.hpp"
+#include "split_complex.hpp"
+
+#include <vector>           // std::vector
+#include <algorithm>        // std::max
+#include <complex>          // std::complex
+#include <cstddef>          // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <type_traits>      // std::enable_if_t, std::is_arithmetic_v
+
+namespace fgs{
+
+/* Class SplitComplexPolynomial. A polynomial with complex coefficients,
+ * stored as two arrays (real parts and imaginary parts) instead of an array
+ * of std::complex<Real>.
+ *
+ * Evaluation, products and differentiation run on the kernels of
+ * split_complex.hpp, which avoid the NaN/Inf recovery of std::complex and
+ * vectorize. It converts to and from Polynomial<std::complex<Real>> (the
+ * polynomial_complex* aliases), which is where the rest of the algorithms
+ * live
+ */
+template <typename Real>
+class SplitComplexPolynomial{
+public:
+    using real_type         = Real;
+    using value_type        = std::complex<Real>;
+    using container_type    = std::vector<Real>;
+    using size_type         = typename container_type::size_type;
+    using polynomial_type   = Polynomial<value_type>;
+
+    explicit SplitComplexPolynomial ()
+        : re(1, Real(0)), im(1, Real(0)) {}
+
+    SplitComplexPolynomial (std::initializer_list<value_type> l)
+        : SplitComplexPolynomial(l.begin(), l.end()) {}
+
+    // Range constructor from complex (or real) coefficients, lowest degree first
+    template <typename InputIt, typename = std::enable_if_t<!std::is_arithmetic_v<InputIt>>>
+    SplitComplexPolynomial (InputIt first, InputIt last){
+        for (; first != last; ++first){
+            const value_type c(*first);
+            re.push_back(c.real());
+            im.push_back(c.imag());
+        }
+
+        if (re.empty()){
+            re.push_back(Real(0));
+            im.push_back(Real(0));
+        }
+        adjust_degree();
+    }
+
+    template <typename CType>
+    explicit SplitComplexPolynomial (const Polynomial<CType>& pol)
+        : SplitComplexPolynomial(pol.begin(), pol.end()) { var = pol.get_variable(); }
+
+    explicit operator polynomial_type () const{
+        std::vector<value_type> c(re.size());
+        for (size_type i=0; i<c.size(); ++i)
+            c[i] = value_type(re[i], im[i]);
+
+        polynomial_type ret(c.begin(), c.end());
+        ret.set_variable(var);
+        return ret;
+    }
+
+    polynomial_type to_polynomial () const{
+        return this->operator polynomial_type();
+    }
+
+    value_type operator[] (size_type i) const { return value_type(re[i], im[i]); }
+    value_type first() const { return (*this)[0]; }
+    value_type last() const { return (*this)[degree()]; }
+
+    // The real and imaginary parts of the coefficients, lowest degree first
+    const container_type& real () const noexcept{ return re; }
+    const container_type& imag () const noexcept{ return im; }
+
+    void set_coefficient (size_type i, const value_type& elem){
+        if (i >= re.size()){
+            re.resize(i+1, Real(0));
+            im.resize(i+1, Real(0));
+        }
+
+        re[i] = elem.real();
+        im[i] = elem.imag();
+        adjust_degree();
+    }
+
+    char get_variable () const noexcept{ return var; }
+    void set_variable (char c) noexcept{ var = c; }
+
+    size_type degree () const noexcept{ return re.size()-1; }
+
+    // Horner's evaluation at a real or complex x
+    template <typename RType>
+    value_type evaluate_at (const RType& x) const{
+        const value_type cx(x);
+        Real yr, yi;
+        split_aux::horner(re, im, cx.real(), cx.imag(), yr, yi);
+        return value_type(yr, yi);
+    }
+
+    // Evaluation at many points at once, vectorized across the points
+    template <typename RType>
+    std::vector<value_type> evaluate_at (const std::vector<RType>& x) const{
+        container_type xr(x.size()), xi(x.size()), yr, yi;
+        for (size_type j=0; j<x.size(); ++j){
+            const value_type cx(x[j]);
+            xr[j] = cx.real();
+            xi[j] = cx.imag();
+        }
+
+        split_aux::horner(re, im, xr, xi, yr, yi);
+
+        std::vector<value_type> ret(x.size());
+        for (size_type j=0; j<x.size(); ++j)
+            ret[j] = value_type(yr[j], yi[j]);
+        return ret;
+    }
+
+    template <typename RType>
+    auto operator() (const RType& x) const{
+        return evaluate_at(x);
+    }
+
+    SplitComplexPolynomial operator+ () const { return *this; }
+    SplitComplexPolynomial operator- () const{
+        SplitComplexPolynomial ret(*this);
+        for (size_type i=0; i<re.size(); ++i){
+            ret.re[i] = -re[i];
+            ret.im[i] = -im[i];
+        }
+        return ret;
+    }
+
+    SplitComplexPolynomial& operator+= (const SplitComplexPolynomial& pol){
+        resize(std::max(re.size(), pol.re.size()));
+
+        for (size_type i=0; i<pol.re.size(); ++i){
+            re[i] += pol.re[i];
+            im[i] += pol.im[i];
+        }
+
+        adjust_degree();
+        return *this;
+    }
+
+    SplitComplexPolynomial& operator-= (const SplitComplexPolynomial& pol){
+        resize(std::max(re.size(), pol.re.size()));
+
+        for (size_type i=0; i<pol.re.size(); ++i){
+            re[i] -= pol.re[i];
+            im[i] -= pol.im[i];
+        }
+
+        adjust_degree();
+        return *this;
+    }
+
+    SplitComplexPolynomial& operator*= (const SplitComplexPolynomial& pol){
+        container_type cr, ci;
+        split_aux::convolve(re, im, pol.re, pol.im, cr, ci);
+
+        re = std::move(cr);
+        im = std::move(ci);
+        adjust_degree();
+        return *this;
+    }
+
+    SplitComplexPolynomial& operator*= (const value_type& s){
+        const Real sr = s.real(), si = s.imag();
+
+        for (size_type i=0; i<re.size(); ++i)
+            split_aux::multiply(re[i], im[i], sr, si, re[i], im[i]);
+
+        adjust_degree();
+        return *this;
+    }
+
+    SplitComplexPolynomial& differentiate (){
+        split_aux::differentiate(re, im);
+        return *this;
+    }
+
+    friend bool operator== (const SplitComplexPolynomial& lhs, const SplitComplexPolynomial& rhs){
+        return lhs.re == rhs.re && lhs.im == rhs.im;
+    }
+    friend bool operator!= (const SplitComplexPolynomial& lhs, const SplitComplexPolynomial& rhs){
+        return !(lhs == rhs);
+    }
+
+private:
+    container_type re;  // Real parts of the coefficients
+    container_type im;  // Imaginary parts of the coefficients
+    char var = 'x';     // Letter that identifies the variable
+
+    void resize (size_type n){
+        re.resize(n, Real(0));
+        im.resize(n, Real(0));
+    }
+
+    // Helper function to adjust the degree, so the last coefficient is not 0
+    void adjust_degree (){
+        while (re.size() > 1 && re.back() == Real(0) && im.back() == Real(0)){
+            re.pop_back();
+            im.pop_back();
+        }
+    }
+};
+
+template <typename Real>
+SplitComplexPolynomial<Real> operator+ (SplitComplexPolynomial<Real> lhs, const SplitComplexPolynomial<Real>& rhs){
+    return lhs += rhs;
+}
+template <typename Real>
+SplitComplexPolynomial<Real> operator- (SplitComplexPolynomial<Real> lhs, const SplitComplexPolynomial<Real>& rhs){
+    return lhs -= rhs;
+}
+template <typename Real>
+SplitComplexPolynomial<Real> operator* (SplitComplexPolynomial<Real> lhs, const SplitComplexPolynomial<Real>& rhs){
+    return lhs *= rhs;
+}
+
+// Like SplitComplexPolynomial::differentiate, but returning an rvalue
+template <typename Real>
+SplitComplexPolynomial<Real> differentiate (SplitComplexPolynomial<Real> pol){
+    return pol.differentiate();
+}
+
+// Split counterparts of the polynomial_complex* aliases
+using polynomial_split_complex_float        = SplitComplexPolynomial<float>;
+using polynomial_split_complex_double       = SplitComplexPolynomial<double>;
+using polynomial_split_complex_long_double  = SplitComplexPolynomial<long double>;
+
+using polynomial_split_complex  = polynomial_split_complex_double;
+
+}  // namespace fgs
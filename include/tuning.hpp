@@ -0,0 +1,272 @@
+#pragma once
+
+#include "detail.hpp"
+
+#include <array>        // std::array
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <cstdlib>      // std::getenv
+#include <fstream>      // std::ifstream, std::ofstream
+#include <istream>      // std::istream
+#include <limits>       // std::numeric_limits
+#include <map>          // std::map
+#include <mutex>        // std::mutex, std::lock_guard
+#include <ostream>      // std::ostream
+#include <sstream>      // std::istringstream
+#include <stdexcept>    // std::invalid_argument
+#include <string>       // std::string, std::to_string, std::getline
+#include <type_traits>  // std::is_same_v, std::is_integral_v, std::is_signed_v
+#include <typeinfo>     // typeid
+#include <utility>      // std::move
+
+/* Crossover degrees of the algorithms, tuned per coefficient type
+ *
+ * Every dispatcher that picks between a quadratic kernel and an asymptotically
+ * faster one (FFT products, Newton's division, half-gcd, convolution-based
+ * Taylor shift and the remainder tree) asks threshold<T>() for the size from
+ * which the fast kernel is used. The values come from a tuning profile, a
+ * text file with one "type threshold value" entry per line:
+ *
+ *   # Written by fgs::tuning::autotune_all
+ *   double fft 48
+ *   modint_998244353 newton 96
+ *   complex_double fft 24
+ *
+ * The profile named by the environment variable FGS_TUNING_PROFILE is loaded
+ * the first time a threshold is needed, and can be replaced at any time with
+ * load_profile or set_profile. Types (or thresholds) missing from it use the
+ * entry of the type "default" if there is one, and defaults() otherwise
+ * (DEFAULTS, or INEXACT_DEFAULTS for floating-point coefficients, whose
+ * products only go through the FFT if a profile says so).
+ *
+ * The autotuner that measures the crossovers on the running host and writes
+ * the profile lives in autotune.hpp
+ */
+namespace fgs::tuning{
+    enum class Threshold : std::size_t{
+        fft,            // Size of the shortest operand from which products go through the FFT (or NTT)
+        newton,         // Size of the quotient and the divisor from which Newton's division is used
+        half_gcd,       // Degree from which the half-gcd recursion is used
+        taylor_shift,   // Number of coefficients from which the convolution-based Taylor shift is used
+        evaluation,     // Number of points from which the remainder tree splits instead of using Horner
+        count
+    };
+
+    inline static constexpr std::size_t THRESHOLDS = static_cast<std::size_t>(Threshold::count);
+
+    using Thresholds = std::array<std::size_t, THRESHOLDS>;
+
+    // Type name -> thresholds of that type
+    using Profile = std::map<std::string, Thresholds>;
+
+    // A threshold no size reaches, so the fast kernel is never used
+    inline static constexpr std::size_t NEVER = std::numeric_limits<std::size_t>::max();
+
+    // Values used when no profile says otherwise
+    inline static constexpr Thresholds DEFAULTS = {32, 64, 128, 64, 32};
+
+    /* Defaults of the floating-point and complex types. The error of an FFT
+     * product is relative to its largest coefficient, so the small ones lose
+     * all their digits (think of a power series with fast decaying terms).
+     * Products stay schoolbook unless a profile asks for the FFT
+     */
+    inline static constexpr Thresholds INEXACT_DEFAULTS = {NEVER, 64, 128, 64, 32};
+
+    inline const char* threshold_name (Threshold t){
+        static constexpr std::array<const char*, THRESHOLDS> names = {
+            "fft", "newton", "half_gcd", "taylor_shift", "evaluation"
+        };
+        return names[static_cast<std::size_t>(t)];
+    }
+
+    /* Name of T in the profiles: the one of the polynomial_* aliases for the
+     * floating-point types, intN/uintN for integers and modint_P for ModInt.
+     * Any other type uses its typeid name, which is fine because a profile
+     * only makes sense on the host (and the build) it was tuned on
+     */
+    template <typename T>
+    std::string type_name (){
+        if constexpr (fgs::detail::is_complex_v<T>)
+            return "complex_" + type_name<fgs::detail::reduce_complex_t<T>>();
+        else if constexpr (std::is_same_v<T, float>)
+            return "float";
+        else if constexpr (std::is_same_v<T, double>)
+            return "double";
+        else if constexpr (std::is_same_v<T, long double>)
+            return "long_double";
+        else if constexpr (std::is_integral_v<T>)
+            return (std::is_signed_v<T> ? "int" : "uint") + std::to_string(8*sizeof(T));
+        else if constexpr (fgs::detail::has_modulus_v<T>)
+            return "modint_" + std::to_string(T::modulus);
+        else
+            return typeid(T).name();
+    }
+
+    // Defaults of the type called type (a name given by type_name)
+    inline const Thresholds& defaults (const std::string& type){
+        const std::string real = type.compare(0, 8, "complex_") == 0 ? type.substr(8) : type;
+        if (real == "float" || real == "double" || real == "long_double")
+            return INEXACT_DEFAULTS;
+        return DEFAULTS;
+    }
+
+    /* Parses a profile. Empty lines and lines starting with '#' are skipped,
+     * and thresholds a type doesn't list keep the default value. Throws
+     * std::invalid_argument on a malformed line or an unknown threshold
+     */
+    inline Profile read_profile (std::istream& is){
+        Profile ret;
+        std::string line;
+
+        while (std::getline(is, line)){
+            std::istringstream fields(line);
+            std::string type, name, rest;
+            std::size_t value;
+
+            if (!(fields >> type) || type.front() == '#')
+                continue;
+            if (!(fields >> name >> value) || (fields >> rest))
+                throw std::invalid_argument("fgs::tuning::read_profile: malformed line \"" + line + "\"");
+
+            std::size_t t = 0;
+            while (t < THRESHOLDS && name != threshold_name(static_cast<Threshold>(t)))
+                ++t;
+            if (t == THRESHOLDS)
+                throw std::invalid_argument("fgs::tuning::read_profile: unknown threshold \"" + name + "\"");
+
+            ret.try_emplace(type, defaults(type)).first->second[t] = value;
+        }
+
+        return ret;
+    }
+
+    inline void write_profile (std::ostream& os, const Profile& profile){
+        for (const auto &[type, values] : profile)
+            for (std::size_t t=0; t<THRESHOLDS; ++t)
+                os << type << ' ' << threshold_name(static_cast<Threshold>(t)) << ' ' << values[t] << '\n';
+    }
+
+    namespace detail{
+        struct Registry{
+            std::mutex mutex;
+            Profile profile;
+            // Bumped on every change, so the cached thresholds know they are stale
+            std::atomic<std::uint64_t> generation{1};
+
+            Registry (){
+                if (const char* path = std::getenv("FGS_TUNING_PROFILE")){
+                    // A missing or broken profile must not break the program: the defaults are always valid
+                    try{
+                        std::ifstream file(path);
+                        if (file)
+                            profile = read_profile(file);
+                    }
+                    catch (const std::invalid_argument&) {}
+                }
+            }
+        };
+
+        inline Registry& registry (){
+            static Registry r;
+            return r;
+        }
+
+        // Thresholds of T, copied from the profile when it changes
+        template <typename T>
+        struct Cache{
+            std::array<std::atomic<std::size_t>, THRESHOLDS> values{};
+            std::atomic<std::uint64_t> generation{0};
+        };
+
+        template <typename T>
+        Cache<T>& cache (){
+            static Cache<T> c;
+            return c;
+        }
+
+        // Thresholds of the type called name (the caller must hold the mutex)
+        inline Thresholds lookup (const Registry& r, const std::string& name){
+            if (const auto it = r.profile.find(name); it != r.profile.end())
+                return it->second;
+            if (const auto it = r.profile.find("default"); it != r.profile.end())
+                return it->second;
+            return defaults(name);
+        }
+
+        template <typename T>
+        void refresh (Cache<T>& c){
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+
+            const auto values = lookup(r, type_name<T>());
+            for (std::size_t t=0; t<THRESHOLDS; ++t)
+                c.values[t].store(values[t], std::memory_order_relaxed);
+            c.generation.store(r.generation.load(std::memory_order_relaxed), std::memory_order_release);
+        }
+    }
+
+    /* Current value of a threshold of T. This is what the dispatchers call,
+     * so once the profile is loaded it only costs two atomic loads
+     */
+    template <typename T>
+    std::size_t threshold (Threshold t){
+        auto &c = detail::cache<T>();
+        if (c.generation.load(std::memory_order_acquire) != detail::registry().generation.load(std::memory_order_acquire))
+            detail::refresh(c);
+
+        return c.values[static_cast<std::size_t>(t)].load(std::memory_order_relaxed);
+    }
+
+    // Current thresholds of T
+    template <typename T>
+    Thresholds thresholds (){
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return detail::lookup(r, type_name<T>());
+    }
+
+    // Replaces the thresholds of T
+    template <typename T>
+    void set_thresholds (const Thresholds& values){
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.profile[type_name<T>()] = values;
+        r.generation.fetch_add(1, std::memory_order_release);
+    }
+
+    // Copy of the current profile
+    inline Profile profile (){
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return r.profile;
+    }
+
+    // Replaces the whole profile (an empty one restores the defaults)
+    inline void set_profile (Profile p){
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.profile = std::move(p);
+        r.generation.fetch_add(1, std::memory_order_release);
+    }
+
+    /* Replaces the profile with the one in the file path. Returns false
+     * (keeping the current one) if the file can't be opened, and throws
+     * std::invalid_argument if it is malformed
+     */
+    inline bool load_profile (const std::string& path){
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        set_profile(read_profile(file));
+        return true;
+    }
+
+    // Writes the current profile to the file path. Returns false if it can't be written
+    inline bool save_profile (const std::string& path){
+        std::ofstream file(path);
+        write_profile(file, profile());
+        return static_cast<bool>(file);
+    }
+}  // namespace fgs::tuning
@@ -0,0 +1,123 @@
+// The copy-on-write storage changes the code of the library, so it gets its
+// own test program instead of sharing unit_tests.cpp
+#define COPY_ON_WRITE_SUPPORT
+#include "polynomial.hpp"
+
+#include <vector>
+#include <thread>
+#include <utility>
+
+// Boost's Unit Test Framework
+#define BOOST_TEST_MODULE Copy On Write Test
+#include <boost/test/unit_test.hpp>
+
+// Whether p and q share their coefficients (read through const references, so they stay shared)
+template <typename T>
+bool shared(const fgs::Polynomial<T>& p, const fgs::Polynomial<T>& q){
+    return &p[0] == &q[0];
+}
+
+BOOST_AUTO_TEST_CASE(sharing_test){
+    const fgs::polynomial_double p{1, 2, 3, 4};
+    auto q = p;
+    fgs::polynomial_double r(p);
+    BOOST_TEST((shared(p, q) && shared(p, r)));
+
+    // Writing detaches only the polynomial written
+    q += fgs::polynomial_double{1};
+    BOOST_TEST((!shared(p, q) && shared(p, r)));
+    BOOST_TEST((p == fgs::polynomial_double{1, 2, 3, 4} && q == fgs::polynomial_double{2, 2, 3, 4}));
+
+    r.set_coefficient(5, 1.0);
+    BOOST_TEST((p.degree() == 3 && r.degree() == 5));
+
+    // Results of the free operators and copies of them share too
+    auto s = p*p;
+    const auto t = s;
+    BOOST_TEST((shared(s, t)));
+    s *= s;
+    BOOST_TEST((t == p*p && s == t*t));
+
+    // Aliased operands
+    auto u = p;
+    u -= u;
+    BOOST_TEST((u == fgs::polynomial_double() && p.degree() == 3));
+}
+
+BOOST_AUTO_TEST_CASE(escape_test){
+    fgs::polynomial_double p{1, 2, 3};
+    const auto q = p;
+
+    // A mutable reference detaches p, and keeps its later copies deep
+    double &first = p[0];
+    BOOST_TEST((!shared(p, q)));
+    const auto r = p;
+    first = 10;
+    BOOST_TEST((p[0] == 10 && r[0] == 1 && q[0] == 1));
+    BOOST_TEST((!shared(p, r)));
+
+    // Assigning p makes it shareable again
+    p = q;
+    BOOST_TEST((shared(p, q)));
+}
+
+BOOST_AUTO_TEST_CASE(kernels_test){
+    const fgs::polynomial_double a{-1, 0, 0, 1}, b{-1, 1};
+    auto out = a;
+    fgs::add_into(out, a, b);
+    BOOST_TEST((out == fgs::polynomial_double{-2, 1, 0, 1} && a == fgs::polynomial_double{-1, 0, 0, 1}));
+
+    auto q = a, r = a;
+    fgs::divmod(a, b, q, r);
+    BOOST_TEST((q == fgs::polynomial_double{1, 1, 1} && r == fgs::polynomial_double()));
+
+    auto d = a;
+    a.derivative(2, d);
+    BOOST_TEST((d == fgs::polynomial_double{0, 6} && a.degree() == 3));
+    BOOST_TEST((fgs::gcd(a*b, b*b)(1.0) == 0.0));
+}
+
+BOOST_AUTO_TEST_CASE(moved_from_test){
+    // A moved-from polynomial stays usable, like one holding a moved-from std::vector
+    fgs::polynomial_double p{1, 2, 3};
+    const fgs::polynomial_double q = std::move(p);
+    p += fgs::polynomial_double{3.0};
+    BOOST_TEST((q == fgs::polynomial_double{1, 2, 3} && p == fgs::polynomial_double{3.0}));
+
+    // And so are its copies
+    auto r = std::move(p);
+    fgs::polynomial_double s(p);
+    s = r;
+    p = q;
+    BOOST_TEST((shared(s, r) && shared(p, q) && s == fgs::polynomial_double{3.0}));
+}
+
+BOOST_AUTO_TEST_CASE(threads_test){
+    fgs::polynomial_double p;
+    for (int i=0; i<200; ++i)
+        p.set_coefficient(static_cast<std::size_t>(i), 1.0/(i+1));
+    const auto expected = p*p;
+    const auto &source = p;
+
+    // Each thread copies the shared polynomial many times and writes some copies
+    std::vector<std::thread> threads;
+    std::vector<int> ok(4, 0);
+    for (std::size_t t=0; t<ok.size(); ++t)
+        threads.emplace_back([&source, &expected, &ok, t](){
+            bool good = true;
+            for (int i=0; i<200; ++i){
+                auto copy = source;
+                if (i%3 == 0){
+                    copy *= source;
+                    good = good && copy == expected;
+                }
+                else
+                    good = good && std::as_const(copy)[199] == source[199];
+            }
+            ok[t] = good;
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    BOOST_TEST((ok == std::vector<int>(ok.size(), 1)));
+}
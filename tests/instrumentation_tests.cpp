@@ -0,0 +1,85 @@
+// The instrumentation changes the code of the library, so it gets its own
+// test program instead of sharing unit_tests.cpp
+#define INSTRUMENTATION_SUPPORT
+#include "polynomial.hpp"
+#include "instrumentation.hpp"
+
+#include <vector>
+#include <chrono>
+#include <sstream>
+
+// Boost's Unit Test Framework
+#define BOOST_TEST_MODULE Instrumentation Test
+#include <boost/test/unit_test.hpp>
+
+using fgs::instrumentation::Operation;
+
+BOOST_AUTO_TEST_CASE(counters_test){
+    fgs::instrumentation::reset();
+
+    fgs::polynomial_double p{1, 2, 3}, q{4, 5};
+    auto r = p*q;
+    r += p;
+    BOOST_TEST((r(2.0) == p(2.0)*q(2.0) + p(2.0)));
+
+    auto s = fgs::instrumentation::stats();
+    BOOST_TEST((s[Operation::multiplication].calls == 1));
+    BOOST_TEST((s[Operation::addition].calls == 1));
+    BOOST_TEST((s[Operation::evaluation].calls == 4));
+    BOOST_TEST((s.flops >= 6));
+    BOOST_TEST((s.allocations >= 1));
+
+    std::uint64_t histogram_calls = 0;
+    for (auto elem : s[Operation::evaluation].histogram)
+        histogram_calls += elem;
+    BOOST_TEST((histogram_calls == 4));
+
+    // Durand-Kerner runs for degree 3 and higher
+    fgs::roots_of(fgs::polynomial_double{-6, 11, -6, 1});
+    s = fgs::instrumentation::stats();
+    BOOST_TEST((s[Operation::roots].calls == 1));
+    BOOST_TEST((s.durand_kerner_calls == 1));
+    BOOST_TEST((s.durand_kerner_iterations > 0));
+
+    fgs::instrumentation::reset();
+    BOOST_TEST((fgs::instrumentation::stats().flops == 0));
+}
+
+BOOST_AUTO_TEST_CASE(dump_hook_test){
+    std::vector<std::uint64_t> dumps;
+    fgs::instrumentation::set_dump_hook([&dumps](const fgs::instrumentation::Stats& s){
+        dumps.push_back(s.flops);
+
+        // Operations inside the hook don't dump again
+        BOOST_TEST((fgs::polynomial_double{1, 1}(1.0) == 2.0));
+    }, std::chrono::seconds(0));
+
+    fgs::polynomial_double p{1, 2, 3};
+    p(1.0);
+    p(2.0);
+    BOOST_TEST((dumps.size() == 2));
+
+    fgs::instrumentation::set_dump_hook(nullptr, std::chrono::seconds(0));
+    p(3.0);
+    BOOST_TEST((dumps.size() == 2));
+
+    std::ostringstream os;
+    os << fgs::instrumentation::stats();
+    BOOST_TEST((os.str().find("evaluation") != std::string::npos));
+}
+
+BOOST_AUTO_TEST_CASE(allocation_sites_test){
+    // The scratch buffers of the FFT product (result, packed transform and product) are counted
+    fgs::tuning::set_thresholds<double>({4, 4, 4, 4, 4});
+    fgs::instrumentation::reset();
+    fgs::polynomial_double p(std::vector<double>(16, 1.0)), q(std::vector<double>(16, 2.0));
+    const auto r = p*q;
+    BOOST_TEST((fgs::instrumentation::stats().allocations >= 3));
+    fgs::tuning::set_profile({});
+
+    // So are the copies of the division
+    fgs::instrumentation::reset();
+    const auto s = r % fgs::polynomial_double{1, 1};
+    BOOST_TEST((s.degree() == 0));
+    BOOST_TEST((fgs::instrumentation::stats().allocations >= 1));
+}
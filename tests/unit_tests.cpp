@@ -1,11 +1,29 @@
 #define UNICODE_SUPPORT
 #include "polynomial.hpp"
+#include "power_series.hpp"
+#include "modint.hpp"
+#include "multimodular.hpp"
+#include "polynomial_batch.hpp"
+#include "split_complex_polynomial.hpp"
+#include "autotune.hpp"
+#include "polynomial_store.hpp"
+#include "polynomial_io.hpp"
+#include "chebyshev.hpp"
+#include "compensated.hpp"
+#include "least_squares.hpp"
+#include "piecewise.hpp"
 
 #include <vector>
 #include <algorithm>
 #include <functional>
 #include <iterator>
 #include <random>
+#include <sstream>
+#include <limits>
+#include <iomanip>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 
 // Boost's Unit Test Framework
 #define BOOST_TEST_MODULE Polynomial Test
@@ -163,6 +181,92 @@ bool test_modulus(std::size_t n, std::size_t m){
     return std::equal(v.rbegin(), v.rend(), p.begin(), p.end(), floating_point_comparison<T>);
 }
 
+BOOST_AUTO_TEST_CASE(remainder_truncation_test){
+    // 1 - 49*(1/49) isn't 0 in double, but the remainder's degree must still drop
+    fgs::polynomial_double p{0, 0, 1}, q{1, 49};
+
+    BOOST_TEST((p % q).degree() == 0);
+    BOOST_TEST(fgs::gcd(p, q).degree() == 0);    // Would never end if it didn't
+}
+
+template <typename T>
+bool test_evaluate_with_derivatives(std::size_t n, std::size_t k){
+    std::vector<T> v(n+1), x(10);
+    generate_vector(v);
+    generate_vector(x);
+    std::transform(v.begin(), v.end(), v.begin(), [](const T& e){ return e/T(100); });
+    std::transform(x.begin(), x.end(), x.begin(), [](const T& e){ return e/T(100); });
+
+    const fgs::Polynomial<T> p(v.begin(), v.end());
+    const auto rows = p.evaluate_with_derivatives(x, k);
+    for (std::size_t i=0; i<x.size(); ++i){
+        const auto values = p.evaluate_with_derivatives(x[i], k);
+        auto d = p;
+        for (std::size_t j=0; j<=k; ++j, d.differentiate())
+            if (!floating_point_comparison(values[j], d(x[i])) || !floating_point_comparison(rows[j][i], values[j]))
+                return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool test_derivatives(std::size_t n, std::size_t k){
+    std::vector<T> v(n+1);
+    generate_vector(v);
+    std::transform(v.begin(), v.end(), v.begin(), [](const T& e){ return e/T(100); });
+
+    const fgs::Polynomial<T> p(v.begin(), v.end());
+    auto d = p, in_place = p;
+    for (std::size_t j=0; j<k; ++j)
+        d.differentiate();
+    in_place.derivative(k, in_place);
+
+    const auto a = v.front();
+    const auto values = fgs::derivatives_at(p, a);
+    const auto expected = p.evaluate_with_derivatives(a, n);
+    const auto back = fgs::taylor_polynomial(a, values), dk = fgs::derivative(p, k);
+
+    return std::equal(dk.begin(), dk.end(), d.begin(), d.end(), floating_point_comparison<T>) &&
+           std::equal(in_place.begin(), in_place.end(), d.begin(), d.end(), floating_point_comparison<T>) &&
+           std::equal(values.begin(), values.end(), expected.begin(), expected.end(), floating_point_comparison<T>) &&
+           std::equal(back.begin(), back.end(), p.begin(), p.end(), floating_point_comparison<T>);
+}
+
+template <typename T>
+bool test_kernels(std::size_t n, std::size_t m){
+    std::vector<T> v1(n+1), v2(m+1);
+    generate_vector(v1);
+    generate_vector(v2);
+
+    const fgs::Polynomial<T> a(v1.begin(), v1.end()), b(v2.begin(), v2.end());
+    fgs::Polynomial<T> out, q, r, square(a);
+
+    // The operands may be the output
+    fgs::add_into(out, a, b);
+    bool ok = out == a+b;
+    fgs::sub_into(out, out, b);
+    ok = ok && std::equal(out.begin(), out.end(), a.begin(), a.end(), floating_point_comparison<T>);
+    fgs::multiply_into(out, a, b);
+    ok = ok && out == a*b;
+    fgs::multiply_into(square, square, square);
+    ok = ok && square == a*a;
+    fgs::differentiate_into(out, a);
+    ok = ok && out == fgs::differentiate(a);
+
+    fgs::divmod(a, b, q, r);
+    const auto [quotient, remainder] = fgs::divmod(a, b);
+    ok = ok && q == a/b && r == a%b && quotient == q && remainder == r;
+
+    // Once the buffer has grown, reusing it doesn't reallocate
+    fgs::multiply_into(out, a, b);
+    const T* storage = &out[0];
+    for (std::size_t i=0; i<5; ++i){
+        fgs::multiply_into(out, a, b);
+        fgs::add_into(out, out, b);
+    }
+    return ok && storage == &out[0];
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(polynomial_test, T, test_types){
     // Random test cases for arithmetic operations
     BOOST_TEST((test_addition<T>(upper_degree, upper_degree*2)));
@@ -197,4 +301,988 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(polynomial_test, T, test_types){
     BOOST_TEST((test_division<T>(upper_degree, 0)));
     BOOST_TEST((test_division<T>(0, 0)));
     BOOST_TEST((test_division<T>(0, upper_degree)));
+
+    BOOST_TEST((test_evaluate_with_derivatives<T>(upper_degree*2, 0)));
+    BOOST_TEST((test_evaluate_with_derivatives<T>(upper_degree*2, 3)));
+    BOOST_TEST((test_evaluate_with_derivatives<T>(upper_degree, upper_degree+2)));
+    BOOST_TEST((test_evaluate_with_derivatives<T>(0, 2)));
+
+    BOOST_TEST((test_derivatives<T>(upper_degree*2, 3)));
+    BOOST_TEST((test_derivatives<T>(upper_degree, upper_degree+1)));
+    BOOST_TEST((test_derivatives<T>(0, 0)));
+
+    BOOST_TEST((test_kernels<T>(upper_degree*2, upper_degree)));
+    BOOST_TEST((test_kernels<T>(upper_degree, upper_degree*2)));
+    BOOST_TEST((test_kernels<T>(0, 0)));
+}
+
+template <typename T>
+bool test_taylor_shift(std::size_t n){
+    using TestPol = fgs::Polynomial<T>;
+
+    std::vector<T> v(n+1);
+    generate_vector(v);
+
+    TestPol p(v), q = p.evaluate_at(TestPol{T(0.5), T(1)});
+    TestPol r = fgs::taylor_shift(p, T(0.5));
+
+    return std::equal(q.begin(), q.end(), r.begin(), r.end(), floating_point_comparison<T>);
+}
+
+template <typename T>
+bool test_scale(std::size_t n){
+    using TestPol = fgs::Polynomial<T>;
+
+    std::vector<T> v(n+1);
+    generate_vector(v);
+
+    TestPol p(v), q = p.evaluate_at(TestPol{T(0), T(0.5)});
+    TestPol r = fgs::scale(p, T(0.5));
+
+    return std::equal(q.begin(), q.end(), r.begin(), r.end(), floating_point_comparison<T>);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(shift_test, T, test_types){
+    BOOST_TEST((test_taylor_shift<T>(0)));
+    BOOST_TEST((test_taylor_shift<T>(upper_degree)));
+    BOOST_TEST((test_taylor_shift<T>(upper_degree*2)));
+
+    BOOST_TEST((test_scale<T>(0)));
+    BOOST_TEST((test_scale<T>(upper_degree)));
+    BOOST_TEST((test_scale<T>(upper_degree*2)));
+}
+
+template <typename T>
+bool test_compose(std::size_t n, std::size_t m){
+    using TestPol = fgs::Polynomial<T>;
+
+    std::vector<T> v1(n+1), v2(m+1);
+    generate_vector(v1);
+    generate_vector(v2);
+    std::transform(v1.begin(), v1.end(), v1.begin(), [](const T& x){ return x/T(100); });
+    std::transform(v2.begin(), v2.end(), v2.begin(), [](const T& x){ return x/T(400); });
+    // Keeps the leading coefficient of the result (f_n*g_m^n) away from underflow
+    v2.back() = T(0.5);
+
+    TestPol f(v1), g(v2), h = fgs::compose(f, g);
+    T x(0.5);
+
+    return h.degree() == n*m && floating_point_comparison(h(x), f(g(x)));
+}
+
+template <typename T>
+bool test_compose_mod(std::size_t n, std::size_t m){
+    using TestPol = fgs::Polynomial<T>;
+
+    std::vector<T> v1(n+1), v2(m+1);
+    generate_vector(v1);
+    generate_vector(v2);
+    std::transform(v1.begin(), v1.end(), v1.begin(), [](const T& x){ return x/T(100); });
+    std::transform(v2.begin(), v2.end(), v2.begin(), [](const T& x){ return x/T(400); });
+
+    TestPol f(v1), g(v2), h{T(0.25), T(-0.5), T(0), T(1)};
+    TestPol p = fgs::compose_mod(f, g, h), q = fgs::compose(f, g) % h;
+
+    return std::equal(p.begin(), p.end(), q.begin(), q.end(), floating_point_comparison<T>);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compose_test, T, test_types){
+    BOOST_TEST((test_compose<T>(upper_degree, upper_degree)));
+    BOOST_TEST((test_compose<T>(upper_degree*4, upper_degree)));
+    BOOST_TEST((test_compose<T>(upper_degree*4, upper_degree*2)));
+
+    BOOST_TEST((test_compose_mod<T>(upper_degree, upper_degree)));
+    BOOST_TEST((test_compose_mod<T>(upper_degree*4, upper_degree)));
+}
+
+template <typename T>
+bool test_taylor_polynomial(std::size_t n){
+    // Every derivative of exp at a is exp(a)
+    const T a(0.5), x(0.75);
+    std::vector<T> v(n+1, std::exp(a));
+
+    return floating_point_comparison(fgs::taylor_polynomial(a, v)(x), std::exp(x));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(taylor_test, T, test_types){
+    BOOST_TEST((test_taylor_polynomial<T>(upper_degree*4)));
+    BOOST_TEST((test_taylor_polynomial<T>(2000)));
+}
+
+template <typename T>
+fgs::Polynomial<T> random_series(std::size_t n){
+    // 1 + small terms, so every series below is well conditioned
+    std::vector<T> v(n);
+    generate_vector(v);
+    std::transform(v.begin(), v.end(), v.begin(), [n](const T& x){ return x/T(100*n); });
+    v[0] = T(1);
+
+    return fgs::Polynomial<T>(v);
+}
+
+template <typename T>
+bool series_comparison(const fgs::Polynomial<T>& lhs, const fgs::Polynomial<T>& rhs, std::size_t n){
+    for (std::size_t i=0; i<n; ++i)
+        if (!floating_point_comparison(i <= lhs.degree() ? lhs[i] : T(0), i <= rhs.degree() ? rhs[i] : T(0)))
+            return false;
+
+    return true;
+}
+
+template <typename T>
+bool test_series_inverse(std::size_t n){
+    auto a = random_series<T>(n);
+    return series_comparison(fgs::series::mul_trunc(a, fgs::series::inverse(a, n), n), fgs::Polynomial<T>{T(1)}, n);
+}
+
+template <typename T>
+bool test_series_exp_log(std::size_t n){
+    auto a = random_series<T>(n);
+    return series_comparison(fgs::series::exp(fgs::series::log(a, n), n), a, n);
+}
+
+template <typename T>
+bool test_series_sqrt(std::size_t n){
+    auto a = random_series<T>(n), s = fgs::series::sqrt(a, n);
+    return series_comparison(fgs::series::mul_trunc(s, s, n), a, n);
+}
+
+template <typename T>
+bool test_series_pow(std::size_t n){
+    auto a = random_series<T>(n) * fgs::Polynomial<T>{T(0), T(1)};
+    return series_comparison(fgs::series::pow(a, 3, n), fgs::series::mul_trunc(a*a, a, n), n);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(series_test, T, test_types){
+    BOOST_TEST((test_series_inverse<T>(upper_degree*2)));
+    BOOST_TEST((test_series_inverse<T>(100)));
+
+    BOOST_TEST((test_series_exp_log<T>(upper_degree*2)));
+    BOOST_TEST((test_series_exp_log<T>(100)));
+
+    BOOST_TEST((test_series_sqrt<T>(upper_degree*2)));
+    BOOST_TEST((test_series_sqrt<T>(100)));
+
+    BOOST_TEST((test_series_pow<T>(upper_degree*2)));
+    BOOST_TEST((test_series_pow<T>(100)));
+}
+
+template <typename T>
+std::vector<T> clustered_points(std::size_t n){
+    // Points in [-1/64, 1/64], so the coefficients of the product stay small
+    std::vector<T> v(n);
+    generate_vector(v);
+    std::transform(v.begin(), v.end(), v.begin(), [](const T& x){ return x/T(6400); });
+
+    return v;
+}
+
+template <typename T>
+bool test_product_tree(std::size_t n){
+    using TestPol = fgs::Polynomial<T>;
+    using Real = fgs::detail::reduce_complex_t<T>;
+
+    // Roots 0.05k, whose products span many orders of magnitude (float overflows past 30 of them)
+    n = std::is_same_v<Real, float> ? std::min<std::size_t>(n, 30) : n;
+    std::vector<T> v(n);
+    for (std::size_t k=0; k<n; ++k)
+        v[k] = T(Real(0.05)*Real(k));
+
+    TestPol p{T(1)};
+    for (const auto& r : v)
+        p *= TestPol{-r, T(1)};
+
+    // Every coefficient must keep its relative accuracy, not only the largest ones
+    const auto close = [n](const T& a, const T& b){
+        return std::abs(a-b) <= Real(16*n)*std::numeric_limits<Real>::epsilon()*std::abs(b);
+    };
+
+    fgs::ProductTree<T> tree(v);
+    const auto q = fgs::make_polynomial_by_roots(v);
+    return tree.root().degree() == n &&
+        std::equal(p.begin(), p.end(), tree.root().begin(), tree.root().end(), close) &&
+        std::equal(p.begin(), p.end(), q.begin(), q.end(), close);
+}
+
+template <typename T>
+bool test_multipoint_evaluation(std::size_t n){
+    using TestPol = fgs::Polynomial<T>;
+
+    auto v = clustered_points<T>(n);
+    std::vector<T> c(n+n/2);
+    generate_vector(c);
+    std::transform(c.begin(), c.end(), c.begin(), [](const T& x){ return x/T(100); });
+
+    TestPol p(c);
+    fgs::ProductTree<T> tree(v);
+    auto values = tree.evaluate(p);
+
+    for (std::size_t i=0; i<n; ++i)
+        if (!floating_point_comparison(values[i], p(v[i])))
+            return false;
+
+    return true;
+}
+
+template <typename T>
+bool test_tree_interpolation(std::size_t n){
+    using TestPol = fgs::Polynomial<T>;
+
+    std::vector<T> x(n), y(n);
+    for (std::size_t i=0; i<n; ++i)
+        x[i] = T(-1) + T(2)*T(i)/T(n-1);
+
+    std::vector<T> c(n);
+    generate_vector(c);
+    TestPol p(c);
+    std::transform(x.begin(), x.end(), y.begin(), [&p](const T& e){ return p(e)/T(100); });
+    p /= T(100);
+
+    TestPol q = fgs::ProductTree<T>(x).interpolate(y);
+    return std::equal(p.begin(), p.end(), q.begin(), q.end(), floating_point_comparison<T>);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(product_tree_test, T, test_types){
+    BOOST_TEST((test_product_tree<T>(1)));
+    BOOST_TEST((test_product_tree<T>(upper_degree*2+1)));
+    BOOST_TEST((test_product_tree<T>(80)));
+
+    BOOST_TEST((test_multipoint_evaluation<T>(upper_degree*2)));
+    BOOST_TEST((test_multipoint_evaluation<T>(100)));
+
+    BOOST_TEST((test_tree_interpolation<T>(upper_degree)));
+    BOOST_TEST((test_tree_interpolation<T>(upper_degree*2)));
+}
+
+using modint_type = fgs::modint_998244353;
+using modint_pol = fgs::Polynomial<modint_type>;
+
+modint_pol random_modint_polynomial(std::size_t n){
+    std::vector<modint_type> v(n+1);
+    std::generate(v.begin(), v.end(), [](){ return modint_type(gen()); });
+    if (v.back() == modint_type(0))
+        v.back() = modint_type(1);
+
+    return modint_pol(v);
+}
+
+BOOST_AUTO_TEST_CASE(modint_test){
+    BOOST_TEST((modint_type(-1) == modint_type(998244352)));
+    BOOST_TEST((modint_type(3)/modint_type(7)*modint_type(7) == modint_type(3)));
+    BOOST_TEST((modint_type(5).pow(998244352) == modint_type(1)));
+
+    // NTT product against the schoolbook one
+    auto a = random_modint_polynomial(300), b = random_modint_polynomial(500);
+    auto c = fgs::convolution_aux::schoolbook(std::vector<modint_type>(a.begin(), a.end()),
+                                              std::vector<modint_type>(b.begin(), b.end()));
+    auto p = a*b;
+    BOOST_TEST((std::equal(c.begin(), c.end(), p.begin(), p.end())));
+
+    // Exact division
+    auto q = random_modint_polynomial(700), d = random_modint_polynomial(400), r = random_modint_polynomial(300);
+    auto n = q*d + r;
+    BOOST_TEST((n/d == q));
+    BOOST_TEST((n%d == r));
+
+    // Half-gcd
+    auto g = random_modint_polynomial(300);
+    auto h = fgs::gcd(g*random_modint_polynomial(200), g*random_modint_polynomial(150));
+    BOOST_TEST((h/h.last() == g/g.last()));
+
+    // Convolution-based Taylor shift
+    std::vector<modint_type> v(a.begin(), a.end());
+    fgs::shift_aux::taylor_shift_horner(v, modint_type(12345));
+    auto s = fgs::taylor_shift(a, modint_type(12345));
+    BOOST_TEST((std::equal(v.begin(), v.end(), s.begin(), s.end())));
+}
+
+BOOST_AUTO_TEST_CASE(small_prime_test){
+    // In ModInt<7>, k! is 0 from k = 7 on, so neither the shift nor taylor_polynomial may divide by it
+    using small_type = fgs::ModInt<7>;
+    std::uniform_int_distribution<int> dis(0, 6);
+    std::vector<small_type> v(100);
+    std::generate(v.begin(), v.end(), [&dis](){ return small_type(dis(gen)); });
+    v.back() = small_type(1);
+
+    const fgs::Polynomial<small_type> p(v.begin(), v.end()), q = fgs::taylor_shift(p, small_type(1));
+    bool ok = true;
+    for (int x=0; x<7; ++x)
+        ok = ok && q(small_type(x)) == p(small_type(x+1));
+    BOOST_TEST(ok);
+
+    BOOST_CHECK_THROW(fgs::taylor_polynomial(small_type(1), v.begin(), v.end()), std::domain_error);
+
+    // Nor may the k-th derivative
+    auto d = p;
+    for (int k=0; k<3; ++k)
+        d.differentiate();
+    BOOST_TEST((fgs::derivative(p, 3) == d));
+}
+
+using integer_pol = fgs::Polynomial<long long>;
+
+integer_pol random_integer_polynomial(std::size_t n, long long bound){
+    std::uniform_int_distribution<long long> dis(-bound, bound);
+    std::vector<long long> v(n+1);
+    std::generate(v.begin(), v.end(), [&dis](){ return dis(gen); });
+    if (v.back() == 0)
+        v.back() = 1;
+
+    return integer_pol(v);
+}
+
+BOOST_AUTO_TEST_CASE(multimodular_test){
+    // Multi-modular product against the schoolbook one, with coefficients of about 2^48
+    auto a = random_integer_polynomial(300, 1<<20), b = random_integer_polynomial(200, 1<<20);
+    auto c = fgs::convolution_aux::schoolbook(std::vector<long long>(a.begin(), a.end()),
+                                              std::vector<long long>(b.begin(), b.end()));
+    auto p = a*b;
+    BOOST_TEST((std::equal(c.begin(), c.end(), p.begin(), p.end())));
+
+    // Small products that overflow throw like the multi-modular engine, instead of wrapping
+    const long long big = std::numeric_limits<long long>::max()/2 + 1;
+    BOOST_CHECK_THROW((integer_pol{big, 1}*integer_pol{2, 1}), std::overflow_error);
+    BOOST_CHECK_THROW(fgs::convolution_aux::convolve(std::vector<long long>{big, big}, std::vector<long long>{1, 1}), std::overflow_error);
+    BOOST_CHECK_THROW(fgs::convolution_aux::convolve_trunc(std::vector<long long>{1, big}, std::vector<long long>{2, 2}, 2), std::overflow_error);
+    BOOST_TEST((integer_pol{big, -1}*integer_pol{1, 1} == integer_pol{big, big-1, -1}));
+
+    // Exact gcd, up to the content
+    auto g = random_integer_polynomial(40, 50);
+    g /= integer_pol(fgs::gcd_aux::content(g)*(g.last() < 0 ? -1 : 1));
+    auto u = random_integer_polynomial(30, 50), v = random_integer_polynomial(25, 50);
+    auto h = fgs::gcd(g*u*integer_pol(6), g*v*integer_pol(4));
+    BOOST_TEST((h % g == integer_pol() && h.degree() >= g.degree()));
+    BOOST_TEST((fgs::gcd_aux::content(h) % 2 == 0));
+
+    // Exact lcm
+    auto l = fgs::lcm(g*u, g*v);
+    BOOST_TEST((l % (g*u) == integer_pol() && l % (g*v) == integer_pol()));
+}
+
+template <typename T>
+std::vector<fgs::Polynomial<T>> random_polynomials(std::size_t count, std::size_t n){
+    std::vector<fgs::Polynomial<T>> ret;
+    for (std::size_t i=0; i<count; ++i){
+        std::vector<T> v(n - i%3 + 1);
+        generate_vector(v);
+        std::transform(v.begin(), v.end(), v.begin(), [](const T& x){ return x/T(100); });
+        ret.emplace_back(v.begin(), v.end());
+    }
+    return ret;
+}
+
+template <typename T>
+bool test_batch_evaluation(std::size_t count, std::size_t n){
+    const auto pols = random_polynomials<T>(count, n);
+    const fgs::PolynomialBatch<T> batch(pols.begin(), pols.end());
+
+    std::vector<T> x(count);
+    generate_vector(x);
+    std::transform(x.begin(), x.end(), x.begin(), [](const T& e){ return e/T(100); });
+
+    const auto same = batch.evaluate_at(x[0]), each = batch.evaluate_at(x);
+    for (std::size_t i=0; i<count; ++i)
+        if (!floating_point_comparison(same[i], pols[i](x[0])) || !floating_point_comparison(each[i], pols[i](x[i])) ||
+                !floating_point_comparison(batch[i](x[i]), pols[i](x[i])) || batch[i].degree() != pols[i].degree())
+            return false;
+
+    return true;
+}
+
+template <typename T>
+bool test_batch_arithmetic(std::size_t count, std::size_t n, std::size_t m){
+    const auto p = random_polynomials<T>(count, n), q = random_polynomials<T>(count, m);
+    const fgs::PolynomialBatch<T> a(p.begin(), p.end()), b(q.begin(), q.end());
+    const auto sum = a+b, product = a*b, derivative = fgs::differentiate(a);
+
+    const auto equal = [](const auto& view, const fgs::Polynomial<T>& pol){
+        const auto copy = view.to_polynomial();
+        return std::equal(copy.begin(), copy.end(), pol.begin(), pol.end(), floating_point_comparison<T>);
+    };
+
+    for (std::size_t i=0; i<count; ++i)
+        if (!equal(sum[i], p[i]+q[i]) || !equal(product[i], p[i]*q[i]) || !equal(derivative[i], fgs::differentiate(p[i])))
+            return false;
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(batch_test, T, test_types){
+    BOOST_TEST((test_batch_evaluation<T>(1, 0)));
+    BOOST_TEST((test_batch_evaluation<T>(100, upper_degree)));
+
+    BOOST_TEST((test_batch_arithmetic<T>(50, upper_degree, upper_degree/2)));
+    BOOST_TEST((test_batch_arithmetic<T>(50, 2, upper_degree)));
+
+    // Views write through to the batch
+    fgs::PolynomialBatch<T> batch(4, 3);
+    batch[2].assign(fgs::Polynomial<T>{T(1), T(2)});
+    BOOST_TEST((batch.coefficients(1)[2] == T(2) && batch[2].degree() == 1));
+}
+
+template <typename T>
+bool test_split_complex(std::size_t n, std::size_t m){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    using Complex = std::complex<Real>;
+    using SplitPol = fgs::SplitComplexPolynomial<Real>;
+
+    const auto p = random_polynomials<Complex>(1, n).front(), q = random_polynomials<Complex>(1, m).front();
+    const SplitPol a(p), b(q);
+
+    const auto equal = [](const SplitPol& lhs, const fgs::Polynomial<Complex>& rhs){
+        const auto copy = lhs.to_polynomial();
+        return std::equal(copy.begin(), copy.end(), rhs.begin(), rhs.end(), floating_point_comparison<Complex>);
+    };
+
+    std::vector<Complex> x(10);
+    generate_vector(x);
+    std::transform(x.begin(), x.end(), x.begin(), [](const Complex& e){ return e/Real(100); });
+    const auto y = a(x);
+
+    for (std::size_t j=0; j<x.size(); ++j)
+        if (!floating_point_comparison(y[j], p(x[j])) || !floating_point_comparison(a(x[j]), p(x[j])))
+            return false;
+
+    return a.to_polynomial() == p && equal(a+b, p+q) && equal(a-b, p-q) && equal(a*b, p*q) &&
+           equal(fgs::differentiate(a), fgs::differentiate(p));
+}
+
+template <typename T>
+bool test_binary_store(std::size_t n, std::size_t max_degree){
+    auto pols = random_polynomials<T>(n, max_degree);
+    if (n > 0)
+        pols.front().set_variable('z');
+
+    // Single polynomials through a stream, bit for bit
+    for (const auto &p : pols){
+        std::stringstream ss;
+        fgs::write_binary(ss, p);
+        const auto q = fgs::read_binary<T>(ss);
+        if (q != p || q.get_variable() != p.get_variable())
+            return false;
+    }
+
+    // The whole set through a mapped store
+    const auto path = (std::filesystem::temp_directory_path() / "fgs_store_test.bin").string();
+    fgs::write_store<T>(path, pols.begin(), pols.end());
+    bool ok;
+    {
+        const fgs::PolynomialStore<T> store(path);
+        ok = store.size() == n;
+        for (std::size_t i=0; ok && i<n; ++i)
+            ok = store[i].to_polynomial() == pols[i] && store[i].get_variable() == pols[i].get_variable() &&
+                 store[i].evaluate_at(T(0.5)) == pols[i].evaluate_at(T(0.5));
+    }
+    std::remove(path.c_str());
+
+    return ok;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(binary_test, T, test_types){
+    BOOST_TEST((test_binary_store<T>(0, upper_degree)));
+    BOOST_TEST((test_binary_store<T>(data, 3*upper_degree)));
+
+    // Another coefficient type, or something that isn't a polynomial, is rejected
+    std::stringstream ss;
+    fgs::write_binary(ss, fgs::Polynomial<int>{1, 2, 3});
+    BOOST_CHECK_THROW(fgs::read_binary<T>(ss), std::runtime_error);
+    std::stringstream junk("not a polynomial, just some text long enough for a header");
+    BOOST_CHECK_THROW(fgs::read_binary<T>(junk), std::runtime_error);
+
+    // A count of coefficients far beyond the data must not be allocated
+    std::stringstream huge;
+    fgs::write_binary(huge, fgs::Polynomial<T>{T(1), T(2)});
+    std::string bytes = huge.str();
+    bytes.replace(24, 8, 8, '\x7F');
+    std::istringstream corrupted(bytes);
+    BOOST_CHECK_THROW(fgs::read_binary<T>(corrupted), std::runtime_error);
+
+    // Nor can an index entry point into the header
+    const auto path = (std::filesystem::temp_directory_path() / "fgs_store_header_test.bin").string();
+    const std::vector<fgs::Polynomial<T>> one = {fgs::Polynomial<T>{T(1), T(2)}};
+    fgs::write_store<T>(path, one.begin(), one.end());
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(16);
+        char offset[8];
+        file.read(offset, 8);
+        file.seekp(static_cast<std::streamoff>(fgs::store_aux::get<std::uint64_t>(offset)));
+        file.write("\0\0\0\0\0\0\0\0", 8);
+    }
+    BOOST_CHECK_THROW(fgs::PolynomialStore<T>{path}, std::runtime_error);
+    std::remove(path.c_str());
+}
+
+template <typename T>
+bool test_parser(std::size_t n, std::size_t max_degree){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    auto pols = random_polynomials<T>(n, max_degree);
+    std::ostringstream os;
+    os.precision(std::numeric_limits<Real>::max_digits10);
+
+    for (std::size_t i=0; i<pols.size(); ++i){
+        pols[i].set_coefficient(1, T(0));
+        pols[i].set_variable(i%2 ? 'y' : 'x');
+        os << pols[i] << (i%3 ? "\n" : "\r\n\n");
+    }
+
+    // Exact round trip through the stream operators and the bulk parser
+    std::istringstream is(os.str());
+    for (const auto &p : pols){
+        fgs::Polynomial<T> q;
+        if (!(is >> q) || q != p || q.get_variable() != p.get_variable())
+            return false;
+    }
+
+    const auto text = os.str();
+    return fgs::parse_lines<T>(text) == pols;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(parser_test, T, test_types){
+    BOOST_TEST((test_parser<T>(data, upper_degree*3)));
+    BOOST_TEST((test_parser<T>(1, 200)));
+
+    // Hand-written input: ^n exponents, implicit coefficients, unordered terms
+    const std::string s = "-x^3+2.5t-1+t^3+0.5t";
+    fgs::Polynomial<T> p;
+    const auto res = fgs::from_chars(s.data(), s.data()+s.size(), p);
+    BOOST_TEST((res.ec == std::errc() && res.ptr == s.data()+4));
+    BOOST_TEST((fgs::from_chars(s.data()+4, s.data()+s.size(), p).ec == std::errc()));
+    BOOST_TEST((p == fgs::Polynomial<T>{T(-1), T(3), T(0), T(1)} && p.get_variable() == 't'));
+
+    // Bad input fails and keeps the polynomial
+    std::istringstream bad("3x+2y (1,");
+    BOOST_TEST((!(bad >> p) && p.get_variable() == 't'));
+    BOOST_CHECK_THROW(fgs::parse_lines<T>("1+x\n2+\n"), std::invalid_argument);
+
+    // A constant keeps the variable, in both readers
+    std::istringstream constant("7");
+    BOOST_TEST(((constant >> p) && p == fgs::Polynomial<T>{T(7)} && p.get_variable() == 't'));
+    const std::string minus = "-2";
+    BOOST_TEST((fgs::from_chars(minus.data(), minus.data()+minus.size(), p).ec == std::errc() && p.get_variable() == 't'));
+
+    // A polynomial in e can't be read back (its 'e's are exponents of numbers), so it fails instead of being misread
+    fgs::Polynomial<T> q{T(1), T(2), T(3)};
+    q.set_variable('e');
+    std::stringstream round;
+    round << q;
+    BOOST_TEST((!(round >> p) && p == fgs::Polynomial<T>{T(-2)}));
+    for (const std::string e : {"1+2e+3e^2", "3e^2+2e+1", "2E"})
+        BOOST_TEST((fgs::from_chars(e.data(), e.data()+e.size(), p).ec == std::errc::invalid_argument));
+
+    // Exponents of numbers are still read
+    const std::string exponents = "1.5e2+2E+3t";
+    BOOST_TEST((fgs::from_chars(exponents.data(), exponents.data()+exponents.size(), p).ec == std::errc()));
+    BOOST_TEST((p == fgs::Polynomial<T>{T(150), T(2000)}));
+
+    // Huge exponents are out of range instead of allocating them, in every reader
+    const std::string huge = "1+x^99999999999";
+    BOOST_TEST((fgs::from_chars(huge.data(), huge.data()+huge.size(), p).ec == std::errc::result_out_of_range));
+    BOOST_TEST((p == fgs::Polynomial<T>{T(150), T(2000)}));
+    std::istringstream huge_stream(huge);
+    BOOST_TEST(!(huge_stream >> p));
+    BOOST_CHECK_THROW(fgs::parse_lines<T>(huge + "\n"), std::invalid_argument);
+    const std::string big = "x^1048576";
+    BOOST_TEST((fgs::from_chars(big.data(), big.data()+big.size(), p).ec == std::errc() && p.degree() == 1048576));
+}
+
+template <typename T>
+bool test_formatter(std::size_t n, std::size_t max_degree){
+    auto pols = random_polynomials<T>(n, max_degree);
+    pols.emplace_back();
+    pols.emplace_back(T(-2.5));
+    pols.back().set_coefficient(12, T(1.0e+30));
+    pols.back().set_coefficient(3, T(std::numeric_limits<fgs::detail::reduce_complex_t<T>>::infinity()));
+
+    // Same output as the string stream version, whatever the flags
+    const std::vector<std::function<void(std::ostream&)>> setups = {
+        [](std::ostream&){},
+        [](std::ostream& os){ os.precision(std::numeric_limits<fgs::detail::reduce_complex_t<T>>::max_digits10); },
+        [](std::ostream& os){ os << std::fixed << std::setprecision(3); },
+        [](std::ostream& os){ os << std::scientific << std::uppercase << std::showpos; },
+        [](std::ostream& os){ os << std::fixed << std::uppercase; },
+        [](std::ostream& os){ os << std::showpoint; }
+    };
+
+    for (const auto &setup : setups)
+        for (const auto &p : pols){
+            std::ostringstream fast, slow;
+            setup(fast);
+            setup(slow);
+            fast << std::setw(5) << p;
+            slow << std::setw(5);
+            fgs::io_aux::stream_format(slow, p);
+            if (fast.str() != slow.str())
+                return false;
+        }
+
+    // to_chars reports a short buffer, and writes the same as format_to otherwise
+    char buffer[64];
+    for (const auto &p : pols){
+        std::string s;
+        fgs::format_to(std::back_inserter(s), p);
+        const auto res = fgs::to_chars(std::begin(buffer), std::end(buffer), p);
+
+        if (s.size() > sizeof(buffer) ? res.ec != std::errc::value_too_large
+                                       : res.ec != std::errc() || std::string(buffer, res.ptr) != s)
+            return false;
+    }
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(formatter_test, T, test_types){
+    BOOST_TEST((test_formatter<T>(data, upper_degree*3)));
+
+    std::ostringstream os;
+    os << fgs::Polynomial<long long>{-3, 0, 12, -1};
+    BOOST_TEST((os.str() == "-3+12x\u00B2-1x\u00B3"));
+}
+
+template <typename T>
+bool test_chebyshev(std::size_t n, std::size_t m){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    using Cheb = fgs::ChebyshevPolynomial<T>;
+    const Real a(-1), b(2);
+
+    const auto p = random_polynomials<T>(1, n).front(), q = random_polynomials<T>(1, m).front();
+    const Cheb c(p, a, b), d(q, a, b);
+
+    std::vector<T> x(10);
+    generate_vector(x);
+    std::transform(x.begin(), x.end(), x.begin(), [](const T& e){ return e/Real(200); });
+    const auto y = c(x);
+
+    const auto dp = fgs::differentiate(p), ip = fgs::integrate_point(p, a, Real(0)), pq = p*q;
+    const auto dc = fgs::differentiate(c), ic = fgs::integrate(c), cd = c*d;
+
+    for (std::size_t j=0; j<x.size(); ++j)
+        if (!floating_point_comparison(y[j], p(x[j])) || !floating_point_comparison(c(x[j]), p(x[j])) ||
+                !floating_point_comparison(dc(x[j]), dp(x[j])) || !floating_point_comparison(ic(x[j]), ip(x[j])) ||
+                !floating_point_comparison(cd(x[j]), pq(x[j])))
+            return false;
+
+    const auto back = c.to_polynomial();
+    return c.degree() == p.degree() && std::equal(back.begin(), back.end(), p.begin(), p.end(), floating_point_comparison<T>);
+}
+
+template <typename T>
+bool test_chebyshev_product(std::size_t n, std::size_t m){
+    std::vector<T> u(n+1), v(m+1);
+    generate_vector(u);
+    generate_vector(v);
+    std::transform(u.begin(), u.end(), u.begin(), [](const T& e){ return e/T(100); });
+    std::transform(v.begin(), v.end(), v.begin(), [](const T& e){ return e/T(100); });
+
+    const auto direct = fgs::chebyshev_aux::multiply_direct(u, v);
+    const auto transform = fgs::chebyshev_aux::multiply_transform(u, v);
+
+    // operator* picks one of them from chebyshev_aux::TRANSFORM_THRESHOLD
+    const auto product = fgs::ChebyshevPolynomial<T>(u.begin(), u.end())*fgs::ChebyshevPolynomial<T>(v.begin(), v.end());
+    return std::equal(direct.begin(), direct.end(), transform.begin(), transform.end(), floating_point_comparison<T>) &&
+           std::equal(direct.begin(), direct.end(), product.begin(), product.end(), floating_point_comparison<T>);
+}
+
+template <typename T>
+bool test_chebyshev_approximation(std::size_t n){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    const auto p = random_polynomials<T>(1, n).front();
+
+    fgs::ApproximationOptions opt;
+    opt.threads = 2;
+    const auto c = fgs::chebyshev_approximation([&p](Real x){ return p(T(x)); }, Real(-1), Real(2), opt);
+    const auto e = fgs::chebyshev_approximation([](Real x){ return T(std::exp(x)); }, Real(-1), Real(1));
+
+    for (Real x=-1; x<=1; x+=Real(0.125))
+        if (!floating_point_comparison(c(T(x)), p(T(x))) || !floating_point_comparison(e(T(x)), T(std::exp(x))))
+            return false;
+    return c.degree() <= p.degree();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(chebyshev_test, T, test_types){
+    BOOST_TEST((test_chebyshev<T>(0, upper_degree)));
+    BOOST_TEST((test_chebyshev<T>(upper_degree*2, upper_degree)));
+    BOOST_TEST((test_chebyshev_product<T>(0, 3)));
+    BOOST_TEST((test_chebyshev_product<T>(100, 60)));
+    BOOST_TEST((test_chebyshev_product<T>(600, fgs::chebyshev_aux::TRANSFORM_THRESHOLD)));
+    BOOST_TEST((test_chebyshev_approximation<T>(0)));
+    BOOST_TEST((test_chebyshev_approximation<T>(upper_degree*2)));
+
+    BOOST_CHECK_THROW((fgs::ChebyshevPolynomial<T>(1, -1)), std::invalid_argument);
+}
+
+// (x-1)^n expanded, at x = 1 + 2^-k: ill-conditioned, but the exact value 2^-kn is known
+template <typename T>
+bool test_compensated(std::size_t n, int k){
+    fgs::Polynomial<T> p{T(1)};
+    for (std::size_t i=0; i<n; ++i)
+        p *= fgs::Polynomial<T>{T(-1), T(1)};
+
+    const T h = std::ldexp(T(1), -k), x = T(1) + h;
+    const T exact = std::ldexp(T(1), -k*static_cast<int>(n));
+
+    T bound;
+    const T res = fgs::compensated_evaluate(p, x, bound);
+    if (std::abs(res - exact) > bound || std::abs(res - exact) > exact*T(1.0e-3))
+        return false;
+
+    // The batch form gives the same values and bounds
+    std::vector<T> points(10), bounds;
+    generate_vector(points);
+    points.back() = x;
+    const auto values = fgs::compensated_evaluate(p, points, bounds);
+    for (std::size_t i=0; i<points.size(); ++i){
+        T b;
+        if (values[i] != fgs::compensated_evaluate(p, points[i], b) || bounds[i] != b)
+            return false;
+    }
+    return values.back() == res;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compensated_test, T, test_types){
+    if constexpr (std::is_floating_point_v<T>){
+        BOOST_TEST((test_compensated<T>(0, 3)));
+        BOOST_TEST((test_compensated<T>(5, std::numeric_limits<T>::digits/4)));
+        BOOST_TEST((test_compensated<T>(upper_degree*2, std::numeric_limits<T>::digits/8)));
+    }
+}
+
+// Fit of degree n to samples of a polynomial of that degree, plus noise of size h
+template <typename T>
+bool test_least_squares(std::size_t n, T h){
+    std::vector<T> c(n+1);
+    generate_vector(c);
+    fgs::Polynomial<T> p(c);
+    p /= T(100);
+
+    // The samples are dealt to three fitters, as if from three threads
+    fgs::LeastSquaresFitter<T> whole(n, T(-1), T(1));
+    std::vector<fgs::LeastSquaresFitter<T>> parts(3, whole);
+    std::vector<T> x, y;
+    for (std::size_t i=0; i<200; ++i){
+        x.push_back(T(-1) + T(2)*static_cast<T>(i)/T(199));
+        y.push_back(p(x.back()) + (i%2 ? h : -h));
+        parts[i%3].add(x.back(), y.back());
+    }
+    whole.add(x, y);
+    parts[0].merge(parts[1]).merge(parts[2]);
+
+    const auto fit = whole.fit(), merged = parts[0].fit();
+    T rss(0);
+    for (std::size_t i=0; i<x.size(); ++i){
+        rss += (fit.polynomial(x[i]) - y[i])*(fit.polynomial(x[i]) - y[i]);
+        if ((h == T(0) && !floating_point_comparison(fit.polynomial(x[i]), p(x[i]))) ||
+            !floating_point_comparison(merged.polynomial(x[i]), fit.polynomial(x[i])))
+            return false;
+    }
+
+    return merged.count == x.size() && floating_point_comparison(merged.r_squared, fit.r_squared) &&
+           (h == T(0) ? fit.residual_sum_of_squares < T(1.0e-3) : floating_point_comparison(fit.residual_sum_of_squares/rss, T(1)));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(least_squares_test, T, test_types){
+    if constexpr (std::is_floating_point_v<T>){
+        BOOST_TEST((test_least_squares<T>(0, T(0))));
+        BOOST_TEST((test_least_squares<T>(upper_degree*2, T(0))));
+        BOOST_TEST((test_least_squares<T>(upper_degree*2, T(1.0e-4))));
+
+        fgs::LeastSquaresFitter<T> f(3, T(0), T(1)), g(2, T(0), T(1));
+        f.add(T(0.5), T(1));
+        f.add(T(0.5), T(2));
+        BOOST_CHECK_THROW(f.fit(), std::domain_error);
+        BOOST_CHECK_THROW(f.merge(g), std::invalid_argument);
+        BOOST_CHECK_THROW((fgs::LeastSquaresFitter<T>(1, T(1), T(0))), std::invalid_argument);
+    }
+}
+
+// count random pieces of degree about n, over breakpoints spread on [-1, 2]
+template <typename T>
+bool test_piecewise(std::size_t count, std::size_t n){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    const auto pieces = random_polynomials<T>(count, n);
+    std::vector<Real> breaks(count+1);
+    for (std::size_t i=0; i<=count; ++i)
+        breaks[i] = Real(-1) + Real(3)*static_cast<Real>(i*i)/static_cast<Real>(count*count);
+
+    const fgs::PiecewisePolynomial<T> pp(breaks, pieces);
+    const auto derivative = fgs::differentiate(pp);
+
+    std::vector<Real> x(200);
+    generate_vector(x);
+    std::transform(x.begin(), x.end(), x.begin(), [](const Real& e){ return e/Real(50); });
+    x.insert(x.end(), breaks.begin(), breaks.end());
+
+    const auto unsorted = pp(x);
+    std::sort(x.begin(), x.end());
+    const auto sorted = pp(x);
+    for (std::size_t p=0; p<x.size(); ++p){
+        const std::size_t i = std::upper_bound(breaks.begin()+1, breaks.end()-1, x[p]) - (breaks.begin()+1);
+        if (pp.find(x[p]) != i || !floating_point_comparison(sorted[p], pieces[i](T(x[p]))) ||
+            !floating_point_comparison(pp(x[p]), sorted[p]) ||
+            !floating_point_comparison(derivative(x[p]), fgs::differentiate(pieces[i])(T(x[p]))))
+            return false;
+    }
+
+    return std::is_permutation(unsorted.begin(), unsorted.end(), sorted.begin()) &&
+           floating_point_comparison(pp.segment(count-1)(T(2)), pieces[count-1](T(2)));
+}
+
+template <typename T>
+bool test_cubic_spline(std::size_t n){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    const fgs::Polynomial<T> p{T(0.5), T(-1), T(0.25), T(0.125)};
+
+    std::vector<Real> x(n+1);
+    std::vector<T> y(n+1);
+    for (std::size_t i=0; i<=n; ++i){
+        x[i] = Real(-1) + Real(3)*static_cast<Real>(i)/static_cast<Real>(n) + (i%2 ? Real(0.01) : Real(0));
+        y[i] = p(T(x[i]));
+    }
+
+    // A clamped spline reproduces a cubic, and so do its integral and derivative
+    const auto dp = fgs::differentiate(p);
+    const auto clamped = fgs::cubic_spline(x, y, dp(T(x.front())), dp(T(x.back())));
+    const auto natural = fgs::cubic_spline(x, y);
+    const auto slope = fgs::differentiate(natural);
+    for (std::size_t i=0; i<=n; ++i){
+        if (!floating_point_comparison(clamped(x[i] + Real(0.005)), p(T(x[i] + Real(0.005)))) ||
+            !floating_point_comparison(natural(x[i]), y[i]))
+            return false;
+        // The natural spline is C1 at the nodes
+        if (i > 0 && i < n && !floating_point_comparison(slope.segment(i-1)(T(x[i])), slope.segment(i)(T(x[i]))))
+            return false;
+    }
+
+    return floating_point_comparison(fgs::definite_integral(clamped, Real(-0.5), Real(1.5)), fgs::definite_integral(p, T(-0.5), T(1.5)));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(piecewise_test, T, test_types){
+    using Real = fgs::detail::reduce_complex_t<T>;
+    BOOST_TEST((test_piecewise<T>(1, upper_degree)));
+    BOOST_TEST((test_piecewise<T>(7, upper_degree)));
+    BOOST_TEST((test_piecewise<T>(1000, 3)));
+    BOOST_TEST((test_cubic_spline<T>(1)));
+    BOOST_TEST((test_cubic_spline<T>(20)));
+
+    const std::vector<fgs::Polynomial<T>> pieces(2);
+    BOOST_CHECK_THROW((fgs::PiecewisePolynomial<T>({Real(0), Real(1), Real(1)}, pieces)), std::invalid_argument);
+    BOOST_CHECK_THROW((fgs::PiecewisePolynomial<T>({Real(0), Real(1)}, pieces)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(split_complex_test, T, test_types){
+    BOOST_TEST((test_split_complex<T>(0, upper_degree)));
+    BOOST_TEST((test_split_complex<T>(upper_degree*2, upper_degree)));
+    BOOST_TEST((test_split_complex<T>(100, 60)));
+}
+
+BOOST_AUTO_TEST_CASE(tuning_test){
+    using fgs::tuning::Threshold;
+
+    // Profiles survive a round trip, and missing thresholds keep the defaults
+    std::istringstream is("# comment\n\ndouble fft 48\nmodint_998244353 newton 16\n");
+    const auto profile = fgs::tuning::read_profile(is);
+    std::ostringstream os;
+    fgs::tuning::write_profile(os, profile);
+    std::istringstream again(os.str());
+    BOOST_TEST((fgs::tuning::read_profile(again) == profile));
+    BOOST_TEST((profile.at("double")[0] == 48 && profile.at("double")[1] == fgs::tuning::DEFAULTS[1]));
+
+    std::istringstream bad("double fft\n");
+    BOOST_CHECK_THROW(fgs::tuning::read_profile(bad), std::invalid_argument);
+
+    BOOST_TEST((fgs::tuning::type_name<std::complex<long double>>() == "complex_long_double"));
+    BOOST_TEST((fgs::tuning::type_name<long long>() == "int64"));
+    BOOST_TEST((fgs::tuning::type_name<modint_type>() == "modint_998244353"));
+
+    fgs::tuning::set_profile(profile);
+    BOOST_TEST((fgs::tuning::threshold<double>(Threshold::fft) == 48));
+    BOOST_TEST((fgs::tuning::threshold<modint_type>(Threshold::newton) == 16));
+    BOOST_TEST((fgs::tuning::threshold<float>(Threshold::fft) == fgs::tuning::NEVER));
+    BOOST_TEST((fgs::tuning::threshold<float>(Threshold::newton) == fgs::tuning::DEFAULTS[1]));
+
+    // Every path gives the same exact results, whatever the thresholds
+    auto a = random_modint_polynomial(150), b = random_modint_polynomial(100), g = random_modint_polynomial(60);
+    std::vector<modint_pol> results;
+    for (const auto t : {std::size_t(0), fgs::tuning::NEVER}){
+        fgs::tuning::set_thresholds<modint_type>({t, t, t, t, t});
+        fgs::ProductTree<modint_type> tree(b.begin(), b.end());
+        const auto values = tree.evaluate(a);
+
+        results.push_back(a*b);
+        results.push_back(a*b/b);
+        results.push_back(fgs::gcd(g*a, g*b));
+        results.push_back(fgs::taylor_shift(a, modint_type(7)));
+        results.push_back(modint_pol(values));
+    }
+    BOOST_TEST((std::equal(results.begin(), results.begin()+5, results.begin()+5)));
+
+    // The autotuner installs what it measures
+    const auto tuned = fgs::tuning::autotune<modint_type>({64, 0.0001});
+    BOOST_TEST((fgs::tuning::thresholds<modint_type>() == tuned));
+
+    fgs::tuning::set_profile({});
+    BOOST_TEST((fgs::tuning::thresholds<modint_type>() == fgs::tuning::DEFAULTS));
+
+    // Speed alone doesn't enable the FFT of floating-point products
+    BOOST_TEST((fgs::tuning::autotune<double>({64, 0.0001})[0] == fgs::tuning::NEVER));
+
+    // Integers are tuned too (their products choose the multi-modular engine)
+    const auto integers = fgs::tuning::autotune<std::int64_t>({64, 0.0001});
+    BOOST_TEST((fgs::tuning::profile().count("int64") == 1 && fgs::tuning::thresholds<std::int64_t>() == integers));
+    fgs::tuning::set_profile({});
+}
+
+BOOST_AUTO_TEST_CASE(inexact_product_test){
+    // The coefficients of exp(x)^2 = exp(2x) fall fast, and the default product keeps all their digits
+    std::vector<double> v(128);
+    v[0] = 1.0;
+    for (std::size_t k=1; k<v.size(); ++k)
+        v[k] = v[k-1]/double(k);
+
+    const fgs::polynomial_double e(v.begin(), v.end()), square = e*e;
+    double expected = 1.0;
+    bool ok = true;
+    for (std::size_t k=0; k<v.size(); ++k, expected *= 2.0/double(k))
+        ok = ok && std::abs(square[k]-expected) <= 1e-12*expected;
+    BOOST_TEST(ok);
+
+    // Newton's division is only for exact coefficients
+    BOOST_TEST((!fgs::division_aux::use_newton_v<double> && !fgs::division_aux::use_newton_v<std::complex<float>>));
+    BOOST_TEST((fgs::division_aux::use_newton_v<modint_type>));
+}
+
+#ifdef FGS_HAS_CONSTEXPR
+// Simpson's rule weights, as the integrals of the Lagrange basis on {0, 1, 2}
+constexpr std::array<double, 3> simpson_weights (){
+    std::array<double, 3> ret{};
+    for (std::size_t i=0; i<3; ++i)
+        ret[i] = fgs::definite_integral(fgs::lagrange_polynomial({0.0, 1.0, 2.0}, {i==0 ? 1.0 : 0.0, i==1 ? 1.0 : 0.0, i==2 ? 1.0 : 0.0}),
+                                        0.0, 2.0);
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_test){
+    // Tables computed while compiling
+    constexpr auto phi12 = fgs::to_array<5>(fgs::cyclotomic_polynomial<int>(12));
+    static_assert(phi12 == std::array<int, 5>{1, 0, -1, 0, 1});
+
+    constexpr auto exp4 = fgs::to_array<5>(fgs::taylor_polynomial(0.0, {1.0, 1.0, 1.0, 1.0, 1.0}));
+    static_assert(exp4[0] == 1.0 && exp4[2] == 0.5 && exp4[4] == 1.0/24.0);
+
+    constexpr auto weights = simpson_weights();
+    static_assert(weights[1] > 4.0/3.0 - 1e-12 && weights[1] < 4.0/3.0 + 1e-12);
+
+    constexpr auto quotient = fgs::to_array<3>(fgs::divmod(fgs::polynomial{-1.0, 0.0, 0.0, 1.0}, fgs::polynomial{-1.0, 1.0}).first);
+    static_assert(quotient == std::array<double, 3>{1.0, 1.0, 1.0});
+
+    constexpr auto common = fgs::to_array<2>(fgs::monic_polynomial(fgs::gcd(fgs::polynomial{2.0, -3.0, 1.0}, fgs::polynomial{-3.0, 2.0, 1.0})));
+    static_assert(common == std::array<double, 2>{-1.0, 1.0});
+
+    static_assert(fgs::derivative(fgs::pow(fgs::polynomial{1.0, 1.0}, 3), 2)(1.0) == 12.0);
+
+    // Same values at runtime
+    BOOST_TEST((fgs::Polynomial<int>(phi12.begin(), phi12.end()) == fgs::cyclotomic_polynomial<int>(12)));
+    BOOST_TEST((floating_point_comparison(weights[0], 1.0/3.0) && floating_point_comparison(weights[2], 1.0/3.0)));
+    BOOST_CHECK_THROW(fgs::to_array<2>(fgs::polynomial{1.0, 2.0, 3.0}), std::length_error);
 }
+#endif